@@ -27,10 +27,8 @@ FOLDER_EXE="executable"
 FOLDER_RESULT="results"
 
 echo "Compiling files..."
-# Compile the matrix multiplication programs.
-g++ src/matrix.cpp -o $FOLDER_EXE/matrix
-g++ src/matrix_2.cpp -o $FOLDER_EXE/2_matrix
-g++ -O2 -Wall -I p1/eigen-3.4.0/ src/matrix_eigen.cpp -o $FOLDER_EXE/eigen_matrix
+# Compile the matrix multiplication programs (see Makefile).
+make BUILD_DIR=$FOLDER_EXE || exit 1
 
 # Files to store the time results.
 output_file="$FOLDER_RESULT/time_matrix.txt"
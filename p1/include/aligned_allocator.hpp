@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <sys/mman.h>
+
+/*
+    Asignadores para el almacenamiento de las matrices (interfaz estándar de
+    Allocator, se pueden pasar como parámetro de plantilla):
+
+        aligned_allocator<T, 64>   bloque alineado a línea de caché
+        huge_page_allocator<T>     mmap anónimo + madvise(MADV_HUGEPAGE)
+*/
+
+template <typename T, std::size_t Alignment = 64>
+struct aligned_allocator {
+    using value_type = T;
+    static constexpr std::size_t alignment = Alignment;
+
+    template <typename U>
+    struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+    aligned_allocator() noexcept = default;
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n == 0) return nullptr;
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+};
+
+template <typename T, typename U, std::size_t A>
+bool operator==(const aligned_allocator<T, A>&, const aligned_allocator<U, A>&) { return true; }
+template <typename T, typename U, std::size_t A>
+bool operator!=(const aligned_allocator<T, A>&, const aligned_allocator<U, A>&) { return false; }
+
+// Páginas de 2 MB (transparent huge pages): menos fallos de TLB en matrices grandes.
+template <typename T>
+struct huge_page_allocator {
+    using value_type = T;
+    static constexpr std::size_t page_size = std::size_t(2) << 20;
+
+    template <typename U>
+    struct rebind { using other = huge_page_allocator<U>; };
+
+    huge_page_allocator() noexcept = default;
+    template <typename U>
+    huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+    static std::size_t rounded(std::size_t n) {
+        return (n * sizeof(T) + page_size - 1) / page_size * page_size;
+    }
+
+    T* allocate(std::size_t n) {
+        if (n == 0) return nullptr;
+        void* p = mmap(nullptr, rounded(n), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        madvise(p, rounded(n), MADV_HUGEPAGE);
+#endif
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (p) munmap(p, rounded(n));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const huge_page_allocator<T>&, const huge_page_allocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const huge_page_allocator<T>&, const huge_page_allocator<U>&) { return false; }
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sched.h>
+
+/*
+    Medición dentro del proceso: solo se cronometra el cuerpo (p.ej. la
+    multiplicación), nunca el arranque, la reserva ni el relleno aleatorio.
+
+    - `warmup` ejecuciones descartadas (caches, páginas, frecuencia).
+    - Se repite hasta que el intervalo de confianza del 95 % de la media es
+      menor que `target_rel_ci` * media, con un mínimo y un máximo de
+      repeticiones y un límite de tiempo por caso.
+    - Se informa mediana, p95, MAD (desviación absoluta mediana) y GFLOP/s
+      calculados sobre la mediana.
+*/
+
+struct bench_options {
+    unsigned warmup = 2;
+    unsigned min_reps = 5;
+    unsigned max_reps = 100;
+    double max_seconds = 30.0;     // por caso y tamaño
+    double target_rel_ci = 0.02;   // semi-anchura del IC95 relativa a la media
+    uint64_t seed = 1;             // semilla de las entradas aleatorias (A usa seed, B seed + 1)
+};
+
+struct bench_result {
+    std::string name;
+    unsigned size;
+    unsigned threads;
+    std::size_t reps;
+    double median, p95, mad, mean, stddev, ci95;   // segundos
+    double gflops;
+};
+
+// Fija el hilo actual a una CPU (cpu < 0 no hace nada)
+inline bool pin_current_thread(int cpu) {
+    if (cpu < 0) return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// Cuantil por interpolación lineal sobre una muestra ordenada
+inline double quantile_sorted(const std::vector<double>& v, double q) {
+    if (v.empty()) return 0;
+    double pos = q * (v.size() - 1);
+    std::size_t lo = static_cast<std::size_t>(pos);
+    std::size_t hi = std::min(lo + 1, v.size() - 1);
+    return v[lo] + (pos - lo) * (v[hi] - v[lo]);
+}
+
+// t de Student de dos colas al 95 % (aproximación normal a partir de 30)
+inline double student_t95(std::size_t dof) {
+    static const double t[] = {0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                               2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                               2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    return dof < sizeof(t) / sizeof(t[0]) ? t[dof] : 1.96;
+}
+
+inline bench_result summarize(const std::string& name, unsigned size, unsigned threads, double flops,
+                              std::vector<double> samples) {
+    bench_result r{name, size, threads, samples.size(), 0, 0, 0, 0, 0, 0, 0};
+    if (samples.empty()) return r;
+
+    std::sort(samples.begin(), samples.end());
+    r.median = quantile_sorted(samples, 0.5);
+    r.p95 = quantile_sorted(samples, 0.95);
+
+    std::vector<double> dev(samples.size());
+    for (std::size_t i = 0; i < samples.size(); i++) dev[i] = std::fabs(samples[i] - r.median);
+    std::sort(dev.begin(), dev.end());
+    r.mad = quantile_sorted(dev, 0.5);
+
+    double sum = 0;
+    for (double s : samples) sum += s;
+    r.mean = sum / samples.size();
+    double var = 0;
+    for (double s : samples) var += (s - r.mean) * (s - r.mean);
+    r.stddev = samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0;
+    r.ci95 = samples.size() > 1 ? student_t95(samples.size() - 1) * r.stddev / std::sqrt(double(samples.size())) : 0;
+    r.gflops = r.median > 0 ? flops / r.median * 1e-9 : 0;
+    return r;
+}
+
+template <class F>
+bench_result run_benchmark(const std::string& name, unsigned size, unsigned threads, double flops,
+                           F&& body, const bench_options& opt = bench_options()) {
+    using clock = std::chrono::steady_clock;
+
+    for (unsigned i = 0; i < opt.warmup; i++) body();
+
+    std::vector<double> samples;
+    auto begin = clock::now();
+    while (samples.size() < opt.max_reps) {
+        auto t0 = clock::now();
+        body();
+        auto t1 = clock::now();
+        samples.push_back(std::chrono::duration<double>(t1 - t0).count());
+
+        if (samples.size() >= opt.min_reps) {
+            bench_result r = summarize(name, size, threads, flops, samples);
+            if (r.ci95 <= opt.target_rel_ci * r.mean) break;
+        }
+        if (std::chrono::duration<double>(clock::now() - begin).count() > opt.max_seconds &&
+            samples.size() >= std::min(opt.min_reps, 2u)) {
+            break;
+        }
+    }
+    return summarize(name, size, threads, flops, samples);
+}
+
+inline void write_csv(std::ostream& out, const std::vector<bench_result>& results) {
+    out << "name,size,threads,reps,median_s,p95_s,mad_s,mean_s,stddev_s,ci95_s,gflops\n";
+    for (const auto& r : results) {
+        out << r.name << "," << r.size << "," << r.threads << "," << r.reps << ","
+            << r.median << "," << r.p95 << "," << r.mad << "," << r.mean << ","
+            << r.stddev << "," << r.ci95 << "," << r.gflops << "\n";
+    }
+}
+
+inline void write_json(std::ostream& out, const std::vector<bench_result>& results) {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << "  {\"name\": \"" << r.name << "\", \"size\": " << r.size << ", \"threads\": " << r.threads
+            << ", \"reps\": " << r.reps << ", \"median_s\": " << r.median << ", \"p95_s\": " << r.p95
+            << ", \"mad_s\": " << r.mad << ", \"mean_s\": " << r.mean << ", \"stddev_s\": " << r.stddev
+            << ", \"ci95_s\": " << r.ci95 << ", \"gflops\": " << r.gflops << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+}
+
+// Lee lo que escribe write_csv (las líneas que empiezan por '#' se ignoran)
+inline std::vector<bench_result> read_csv(std::istream& in) {
+    std::vector<bench_result> results;
+    std::string line;
+    bool header = true;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        if (header) {
+            header = false;
+            continue;
+        }
+        std::stringstream ss(line);
+        std::string field;
+        std::vector<std::string> f;
+        while (std::getline(ss, field, ',')) f.push_back(field);
+        if (f.size() != 11) {
+            throw std::runtime_error("Malformed benchmark line: " + line);
+        }
+        bench_result r;
+        r.name = f[0];
+        try {
+            r.size = std::stoul(f[1]);
+            r.threads = std::stoul(f[2]);
+            r.reps = std::stoul(f[3]);
+            r.median = std::stod(f[4]);
+            r.p95 = std::stod(f[5]);
+            r.mad = std::stod(f[6]);
+            r.mean = std::stod(f[7]);
+            r.stddev = std::stod(f[8]);
+            r.ci95 = std::stod(f[9]);
+            r.gflops = std::stod(f[10]);
+        } catch (const std::logic_error&) {
+            // stoul / stod: invalid_argument o out_of_range
+            throw std::runtime_error("Malformed benchmark line: " + line);
+        }
+        results.push_back(r);
+    }
+    return results;
+}
+
+/*
+    Línea base para detectar regresiones: el mismo CSV precedido de una
+    cabecera con la versión del formato, una etiqueta (p.ej. el commit) y la
+    CPU en la que se midió.
+
+        # pacs-benchmark-baseline 1
+        # tag 1a2b3c4
+        # cpu Intel(R) Xeon(R) ...
+        name,size,threads,...
+*/
+constexpr int baseline_version = 1;
+
+inline std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            std::size_t colon = line.find(':');
+            return colon == std::string::npos ? "" : line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+    }
+    return "unknown";
+}
+
+struct baseline {
+    std::string tag;
+    std::string cpu;
+    std::vector<bench_result> results;
+};
+
+inline void write_baseline(std::ostream& out, const std::string& tag, const std::vector<bench_result>& results) {
+    out << "# pacs-benchmark-baseline " << baseline_version << "\n"
+        << "# tag " << tag << "\n"
+        << "# cpu " << cpu_model() << "\n";
+    write_csv(out, results);
+}
+
+inline baseline read_baseline(std::istream& in) {
+    baseline b;
+    std::string line;
+    if (!std::getline(in, line) || line.rfind("# pacs-benchmark-baseline ", 0) != 0) {
+        throw std::runtime_error("Not a benchmark baseline file.");
+    }
+    const std::string version = line.substr(26);
+    if (version != std::to_string(baseline_version)) {
+        throw std::runtime_error("Unsupported baseline version " + version + ".");
+    }
+    std::stringstream rest;
+    while (std::getline(in, line)) {
+        if (line.rfind("# tag ", 0) == 0) b.tag = line.substr(6);
+        else if (line.rfind("# cpu ", 0) == 0) b.cpu = line.substr(6);
+        else rest << line << "\n";
+    }
+    b.results = read_csv(rest);
+    return b;
+}
+
+// Semi-anchura del IC95 de la mediana a partir de la MAD: sigma ~ 1.4826 MAD
+// y el error típico de la mediana es ~ 1.2533 sigma / sqrt(reps)
+inline double median_ci95(const bench_result& r) {
+    if (r.reps == 0) return 0;
+    return 1.96 * 1.2533 * 1.4826 * r.mad / std::sqrt(double(r.reps));
+}
+
+// Cambio de la mediana de un caso frente a la línea base
+struct bench_change {
+    std::string name;
+    unsigned size;
+    unsigned threads;
+    double baseline_median;
+    double median;
+    double change_pct;    // > 0: más lento
+    bool significant;     // los IC95 de las dos medianas no se solapan
+    bool regression;      // change_pct > umbral y significativo
+    bool missing;         // está en la línea base pero no se ha medido
+};
+
+// Casos (name, size, threads) presentes en ambos conjuntos, en el orden de
+// results, seguidos de los de la base que no se han medido (missing: un caso
+// quitado o renombrado no debe pasar la comprobación sin más). Un caso solo
+// es una regresión si además de superar el umbral su IC95 queda entero por
+// encima del de la base: un cambio dentro del ruido de alguna de las dos
+// medidas no cuenta.
+inline std::vector<bench_change> compare_baseline(const baseline& base, const std::vector<bench_result>& results,
+                                                  double threshold_pct) {
+    auto same_case = [](const bench_result& a, const bench_result& b) {
+        return a.name == b.name && a.size == b.size && a.threads == b.threads;
+    };
+    std::vector<bench_change> changes;
+    for (const bench_result& r : results) {
+        for (const bench_result& b : base.results) {
+            if (!same_case(b, r) || b.median <= 0) continue;
+            double pct = (r.median / b.median - 1.0) * 100.0;
+            bool significant = std::fabs(r.median - b.median) > median_ci95(r) + median_ci95(b);
+            changes.push_back({r.name, r.size, r.threads, b.median, r.median, pct, significant,
+                               significant && pct > threshold_pct, false});
+        }
+    }
+    for (const bench_result& b : base.results) {
+        bool measured = std::any_of(results.begin(), results.end(),
+                                    [&](const bench_result& r) { return same_case(b, r); });
+        if (!measured) changes.push_back({b.name, b.size, b.threads, b.median, 0, 0, false, false, true});
+    }
+    return changes;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cmath>
+#include <functional>
+
+/*
+    Casos de Eigen de benchmark. Están en su propia unidad de traducción
+    (src/benchmark_eigen.cpp), la única que se compila con EIGEN_FLAGS
+    (-fopenmp -march=native): los kernels propios y el arnés se compilan
+    igual que en el resto de ejecutables.
+
+    Las entradas llegan ya rellenas desde benchmark.cpp (fill_random con la
+    semilla de --seed), así Eigen mide las mismas matrices que los casos
+    propios y random_fill.hpp no se compila con otras opciones en esta
+    unidad. Cada función copia las entradas fuera del cronómetro y devuelve
+    lo que hay que medir; el arnés (benchmark.hpp) queda en benchmark.cpp.
+*/
+
+// Fija los hilos de Eigen (0: los de OpenMP por defecto) y arranca el equipo
+// de OpenMP. Hay que llamarla antes de fijar el hilo principal a una CPU:
+// los hilos de OpenMP heredan la afinidad del hilo que los crea.
+void eigen_start(unsigned threads);
+
+unsigned eigen_threads();
+
+// c = a * b con a, b de n x n por filas
+std::function<void()> eigen_gemm(unsigned n, const double* a, const double* b);
+
+// PartialPivLU o LLT (cholesky) de la matriz a de n x n por filas, la misma
+// que factorizan matrix_lu / matrix_cholesky
+std::function<void()> eigen_factor(bool cholesky, unsigned n, const double* a);
+
+// S = (A + A^T) / 2 con la diagonal dominante: simétrica definida positiva
+template <typename F>
+void make_spd(unsigned n, F s) {
+    for (unsigned i = 0; i < n; i++) {
+        double row = 0;
+        for (unsigned j = 0; j < n; j++) {
+            if (j < i) s(i, j) = s(j, i);
+            if (j != i) row += std::fabs(s(i, j));
+        }
+        s(i, i) = row + 1.0;
+    }
+}
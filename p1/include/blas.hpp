@@ -0,0 +1,502 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "matrix.hpp"
+#include "simd_kernels.hpp"
+#include "thread_pool.hpp"
+
+/*
+    BLAS nivel 1 y 2 sobre el mismo almacenamiento que Matrix<T> (row-major
+    con leading dimension) y vectores con stride (inc >= 1):
+
+        dot    x . y
+        axpy   y = alpha * x + y
+        nrm2   ||x||_2 con suma compensada
+        gemv   y = alpha * op(A) * x + beta * y     op(A) = A o A^T
+        ger    A = alpha * x * y^T + A
+
+    Son operaciones limitadas por memoria: con datos contiguos usan kernels
+    SIMD de la ISA activa (varios acumuladores, para no esperar a la latencia
+    de la suma) y por encima de blas_parallel_work elementos se reparten
+    entre los hilos del pool compartido. Con stride, dot, axpy y nrm2 usan el
+    bucle escalar; gemv y ger copian antes el vector a uno contiguo.
+*/
+
+// Por debajo de este número de elementos se calcula en el hilo que llama
+// (256 KB de doubles: el reparto cuesta más de lo que se gana)
+constexpr std::size_t blas_parallel_work = std::size_t(1) << 15;
+
+// f(first, last, tramo) sobre [0, n) en tramos de múltiplos de 64 elementos
+// (líneas de caché enteras), en paralelo si hay trabajo suficiente. Devuelve
+// el número de tramos (como mucho blas_max_parts()).
+inline std::size_t blas_max_parts() {
+    return thread_pool::current().size();
+}
+
+template <typename F>
+std::size_t blas_for_range(std::size_t n, std::size_t work, F f) {
+    thread_pool& pool = thread_pool::current();
+    if (work < blas_parallel_work || pool.size() == 1) {
+        f(std::size_t(0), n, std::size_t(0));
+        return 1;
+    }
+    const std::size_t parts = pool.size();
+    const std::size_t chunk = ((n + parts - 1) / parts + 63) / 64 * 64;
+    std::size_t count = 0;
+    for (std::size_t first = 0; first < n; first += chunk, count++) {
+        const std::size_t last = std::min(n, first + chunk);
+        pool.submit([&f, first, last, count] { f(first, last, count); });
+    }
+    pool.wait();
+    return count;
+}
+
+// ------------------------------------------------------------- kernels SIMD
+
+// Suma compensada (TwoSum de Knuth, sin ramas): s + e = a + b exactamente
+template <typename T>
+inline void two_sum(T a, T b, T& s, T& e) {
+    s = a + b;
+    T z = s - a;
+    e = (a - (s - z)) + (b - z);
+}
+
+#if PACS_SIMD_X86
+
+__attribute__((target("avx2,fma")))
+inline double dot_avx2(std::size_t n, const double* x, const double* y) {
+    __m256d acc[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+#pragma GCC unroll 4
+        for (int u = 0; u < 4; u++) {
+            acc[u] = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4 * u), _mm256_loadu_pd(y + i + 4 * u), acc[u]);
+        }
+    }
+    __m256d sum = _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]), _mm256_add_pd(acc[2], acc[3]));
+    double tmp[4];
+    _mm256_storeu_pd(tmp, sum);
+    double r = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    for (; i < n; i++) r += x[i] * y[i];
+    return r;
+}
+
+__attribute__((target("avx2,fma")))
+inline float dot_avx2(std::size_t n, const float* x, const float* y) {
+    __m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps(), _mm256_setzero_ps()};
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+#pragma GCC unroll 4
+        for (int u = 0; u < 4; u++) {
+            acc[u] = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8 * u), _mm256_loadu_ps(y + i + 8 * u), acc[u]);
+        }
+    }
+    __m256 sum = _mm256_add_ps(_mm256_add_ps(acc[0], acc[1]), _mm256_add_ps(acc[2], acc[3]));
+    float tmp[8];
+    _mm256_storeu_ps(tmp, sum);
+    float r = ((tmp[0] + tmp[1]) + (tmp[2] + tmp[3])) + ((tmp[4] + tmp[5]) + (tmp[6] + tmp[7]));
+    for (; i < n; i++) r += x[i] * y[i];
+    return r;
+}
+
+__attribute__((target("avx2,fma")))
+inline void axpy_avx2(std::size_t n, double alpha, const double* x, double* y) {
+    const __m256d a = _mm256_set1_pd(alpha);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx2,fma")))
+inline void axpy_avx2(std::size_t n, float alpha, const float* x, float* y) {
+    const __m256 a = _mm256_set1_ps(alpha);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+        _mm256_storeu_ps(y + i + 8, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8)));
+    }
+    for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+// Suma de cuadrados compensada (Dot2 de Ogita-Rump-Oishi): el error del
+// cuadrado sale exacto de la FMA y el de la suma de TwoSum; los dos se
+// acumulan aparte en e. Deja en s y e los dos términos del resultado.
+__attribute__((target("avx2,fma")))
+inline void sumsq_avx2(std::size_t n, const double* x, double& s_out, double& e_out) {
+    // dos pares (s, e) independientes para solapar la latencia de TwoSum
+    __m256d s[2] = {_mm256_setzero_pd(), _mm256_setzero_pd()}, e[2] = {_mm256_setzero_pd(), _mm256_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+#pragma GCC unroll 2
+        for (int u = 0; u < 2; u++) {
+            __m256d v = _mm256_loadu_pd(x + i + 4 * u);
+            __m256d p = _mm256_mul_pd(v, v);
+            __m256d pe = _mm256_fmsub_pd(v, v, p);
+            __m256d t = _mm256_add_pd(s[u], p);
+            __m256d z = _mm256_sub_pd(t, s[u]);
+            __m256d q = _mm256_add_pd(_mm256_sub_pd(s[u], _mm256_sub_pd(t, z)), _mm256_sub_pd(p, z));
+            s[u] = t;
+            e[u] = _mm256_add_pd(e[u], _mm256_add_pd(q, pe));
+        }
+    }
+    double ts[8], te[8];
+    _mm256_storeu_pd(ts, s[0]);
+    _mm256_storeu_pd(ts + 4, s[1]);
+    _mm256_storeu_pd(te, e[0]);
+    _mm256_storeu_pd(te + 4, e[1]);
+    double sum = 0, err = 0;
+    for (int l = 0; l < 8; l++) {
+        double q;
+        two_sum(sum, ts[l], sum, q);
+        err += q + te[l];
+    }
+    for (; i < n; i++) {
+        double p = x[i] * x[i], q;
+        err += std::fma(x[i], x[i], -p);
+        two_sum(sum, p, sum, q);
+        err += q;
+    }
+    s_out = sum;
+    e_out = err;
+}
+
+__attribute__((target("avx512f")))
+inline double dot_avx512(std::size_t n, const double* x, const double* y) {
+    __m512d acc[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+#pragma GCC unroll 4
+        for (int u = 0; u < 4; u++) {
+            acc[u] = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8 * u), _mm512_loadu_pd(y + i + 8 * u), acc[u]);
+        }
+    }
+    double tmp[8];
+    _mm512_storeu_pd(tmp, _mm512_add_pd(_mm512_add_pd(acc[0], acc[1]), _mm512_add_pd(acc[2], acc[3])));
+    double r = 0;
+    for (int l = 0; l < 8; l++) r += tmp[l];
+    for (; i < n; i++) r += x[i] * y[i];
+    return r;
+}
+
+__attribute__((target("avx512f")))
+inline float dot_avx512(std::size_t n, const float* x, const float* y) {
+    __m512 acc[4] = {_mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps(), _mm512_setzero_ps()};
+    std::size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+#pragma GCC unroll 4
+        for (int u = 0; u < 4; u++) {
+            acc[u] = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16 * u), _mm512_loadu_ps(y + i + 16 * u), acc[u]);
+        }
+    }
+    float tmp[16];
+    _mm512_storeu_ps(tmp, _mm512_add_ps(_mm512_add_ps(acc[0], acc[1]), _mm512_add_ps(acc[2], acc[3])));
+    float r = 0;
+    for (int l = 0; l < 16; l++) r += tmp[l];
+    for (; i < n; i++) r += x[i] * y[i];
+    return r;
+}
+
+__attribute__((target("avx512f")))
+inline void axpy_avx512(std::size_t n, double alpha, const double* x, double* y) {
+    const __m512d a = _mm512_set1_pd(alpha);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        _mm512_storeu_pd(y + i + 8, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8)));
+    }
+    for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx512f")))
+inline void axpy_avx512(std::size_t n, float alpha, const float* x, float* y) {
+    const __m512 a = _mm512_set1_ps(alpha);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        _mm512_storeu_ps(y + i, _mm512_fmadd_ps(a, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+        _mm512_storeu_ps(y + i + 16, _mm512_fmadd_ps(a, _mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16)));
+    }
+    for (; i < n; i++) y[i] += alpha * x[i];
+}
+
+#endif  // PACS_SIMD_X86
+
+// x . y contiguos con el kernel de la ISA activa
+template <typename T>
+T blas_dot_kernel(std::size_t n, const T* x, const T* y) {
+    T r = 0;
+    for (std::size_t i = 0; i < n; i++) r += x[i] * y[i];
+    return r;
+}
+
+// y += alpha * x contiguos
+template <typename T>
+void blas_axpy_kernel(std::size_t n, T alpha, const T* x, T* y) {
+    for (std::size_t i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+// sum x[i]^2 = s + e (compensada) sobre datos contiguos
+template <typename T>
+void blas_sumsq_kernel(std::size_t n, const T* x, T& s, T& e) {
+    s = e = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        T p = x[i] * x[i], q;
+        e += std::fma(x[i], x[i], -p);
+        two_sum(s, p, s, q);
+        e += q;
+    }
+}
+
+#if PACS_SIMD_X86
+template <>
+inline double blas_dot_kernel<double>(std::size_t n, const double* x, const double* y) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: return dot_avx512(n, x, y);
+        case simd_isa::avx2: return dot_avx2(n, x, y);
+        default: {
+            double r = 0;
+            for (std::size_t i = 0; i < n; i++) r += x[i] * y[i];
+            return r;
+        }
+    }
+}
+
+template <>
+inline float blas_dot_kernel<float>(std::size_t n, const float* x, const float* y) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: return dot_avx512(n, x, y);
+        case simd_isa::avx2: return dot_avx2(n, x, y);
+        default: {
+            float r = 0;
+            for (std::size_t i = 0; i < n; i++) r += x[i] * y[i];
+            return r;
+        }
+    }
+}
+
+template <>
+inline void blas_axpy_kernel<double>(std::size_t n, double alpha, const double* x, double* y) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: axpy_avx512(n, alpha, x, y); return;
+        case simd_isa::avx2: axpy_avx2(n, alpha, x, y); return;
+        default: for (std::size_t i = 0; i < n; i++) y[i] += alpha * x[i];
+    }
+}
+
+template <>
+inline void blas_axpy_kernel<float>(std::size_t n, float alpha, const float* x, float* y) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: axpy_avx512(n, alpha, x, y); return;
+        case simd_isa::avx2: axpy_avx2(n, alpha, x, y); return;
+        default: for (std::size_t i = 0; i < n; i++) y[i] += alpha * x[i];
+    }
+}
+
+// La suma compensada no gana nada con zmm (la limita la cadena de
+// dependencias de s, no el ancho), así que AVX-512 también usa la de AVX2
+template <>
+inline void blas_sumsq_kernel<double>(std::size_t n, const double* x, double& s, double& e) {
+    if (simd_active_isa() != simd_isa::scalar) {
+        sumsq_avx2(n, x, s, e);
+        return;
+    }
+    s = e = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        double p = x[i] * x[i], q;
+        e += std::fma(x[i], x[i], -p);
+        two_sum(s, p, s, q);
+        e += q;
+    }
+}
+#endif
+
+// ------------------------------------------------------------------ nivel 1
+
+template <typename T>
+T dot(std::size_t n, const T* x, std::ptrdiff_t incx, const T* y, std::ptrdiff_t incy) {
+    if (incx != 1 || incy != 1) {
+        T r = 0;
+        for (std::size_t i = 0; i < n; i++) r += x[i * incx] * y[i * incy];
+        return r;
+    }
+    // Un resultado parcial por tramo, sumados en orden: mismo resultado con
+    // el mismo número de hilos
+    std::vector<T> partial(blas_max_parts(), T(0));
+    std::size_t parts = blas_for_range(n, n, [&](std::size_t first, std::size_t last, std::size_t p) {
+        partial[p] = blas_dot_kernel(last - first, x + first, y + first);
+    });
+    T r = 0;
+    for (std::size_t p = 0; p < parts; p++) r += partial[p];
+    return r;
+}
+
+template <typename T>
+void axpy(std::size_t n, T alpha, const T* x, std::ptrdiff_t incx, T* y, std::ptrdiff_t incy) {
+    if (alpha == T(0)) return;
+    if (incx != 1 || incy != 1) {
+        for (std::size_t i = 0; i < n; i++) y[i * incy] += alpha * x[i * incx];
+        return;
+    }
+    blas_for_range(n, n, [&](std::size_t first, std::size_t last, std::size_t) {
+        blas_axpy_kernel(last - first, alpha, x + first, y + first);
+    });
+}
+
+/*
+    ||x||_2 = sqrt(sum x[i]^2) con la suma de cuadrados compensada (error del
+    orden de una unidad de redondeo, independiente de n). Si los cuadrados
+    desbordan o se pierden por debajo del menor normal, se repite escalando
+    por max |x[i]|.
+*/
+template <typename T>
+T nrm2(std::size_t n, const T* x, std::ptrdiff_t incx) {
+    T s = 0, e = 0;
+    if (incx != 1) {
+        for (std::size_t i = 0; i < n; i++) {
+            T v = x[i * incx], p = v * v, q;
+            e += std::fma(v, v, -p);
+            two_sum(s, p, s, q);
+            e += q;
+        }
+    } else {
+        std::vector<T> ps(blas_max_parts(), T(0)), pe(ps.size(), T(0));
+        std::size_t parts = blas_for_range(n, n, [&](std::size_t first, std::size_t last, std::size_t p) {
+            blas_sumsq_kernel(last - first, x + first, ps[p], pe[p]);
+        });
+        for (std::size_t p = 0; p < parts; p++) {
+            T q;
+            two_sum(s, ps[p], s, q);
+            e += q + pe[p];
+        }
+    }
+    T sum = s + e;
+    if (std::isfinite(sum) && sum >= std::numeric_limits<T>::min()) return std::sqrt(sum);
+
+    T scale = 0;
+    for (std::size_t i = 0; i < n; i++) scale = std::max(scale, std::fabs(x[i * incx]));
+    if (scale == T(0) || !std::isfinite(scale)) return scale;
+    s = e = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        T v = x[i * incx] / scale, p = v * v, q;
+        e += std::fma(v, v, -p);
+        two_sum(s, p, s, q);
+        e += q;
+    }
+    return scale * std::sqrt(s + e);
+}
+
+// ------------------------------------------------------------------ nivel 2
+
+/*
+    y = alpha * A * x + beta * y        (trans = false, A: m x n, y: m)
+    y = alpha * A^T * x + beta * y      (trans = true,  y: n)
+
+    Sin trasponer cada y[i] es un dot con la fila i (filas repartidas entre
+    hilos). Traspuesta, y se acumula con un axpy por fila de A; los hilos se
+    reparten columnas para no escribir el mismo y.
+*/
+template <typename T>
+void gemv(bool trans, std::size_t m, std::size_t n, T alpha, const T* a, std::size_t lda,
+          const T* x, std::ptrdiff_t incx, T beta, T* y, std::ptrdiff_t incy) {
+    const std::size_t lenx = trans ? m : n, leny = trans ? n : m;
+    // y contiguo (los kernels SIMD no tienen stride); x con stride se copia
+    std::vector<T> xc, yc;
+    if (incx != 1) {
+        xc.resize(lenx);
+        for (std::size_t i = 0; i < lenx; i++) xc[i] = x[i * incx];
+        x = xc.data();
+    }
+    T* yd = y;
+    if (incy != 1) {
+        yc.resize(leny);
+        for (std::size_t i = 0; i < leny; i++) yc[i] = y[i * incy];
+        yd = yc.data();
+    }
+
+    if (beta != T(1)) {
+        for (std::size_t i = 0; i < leny; i++) yd[i] = (beta == T(0)) ? T(0) : beta * yd[i];
+    }
+    if (alpha != T(0) && m > 0 && n > 0) {
+        if (!trans) {
+            blas_for_range(m, m * n, [&](std::size_t first, std::size_t last, std::size_t) {
+                for (std::size_t i = first; i < last; i++) yd[i] += alpha * blas_dot_kernel(n, a + i * lda, x);
+            });
+        } else {
+            blas_for_range(n, m * n, [&](std::size_t first, std::size_t last, std::size_t) {
+                for (std::size_t i = 0; i < m; i++) {
+                    blas_axpy_kernel(last - first, alpha * x[i], a + i * lda + first, yd + first);
+                }
+            });
+        }
+    }
+
+    if (incy != 1) {
+        for (std::size_t i = 0; i < leny; i++) y[i * incy] = yd[i];
+    }
+}
+
+// A = alpha * x * y^T + A     A: m x n, x: m, y: n
+template <typename T>
+void ger(std::size_t m, std::size_t n, T alpha, const T* x, std::ptrdiff_t incx, const T* y, std::ptrdiff_t incy,
+         T* a, std::size_t lda) {
+    if (alpha == T(0)) return;
+    // y contiguo para el kernel SIMD
+    std::vector<T> yc;
+    if (incy != 1) {
+        yc.resize(n);
+        for (std::size_t j = 0; j < n; j++) yc[j] = y[j * incy];
+        y = yc.data();
+    }
+    blas_for_range(m, m * n, [&](std::size_t first, std::size_t last, std::size_t) {
+        for (std::size_t i = first; i < last; i++) blas_axpy_kernel(n, alpha * x[i * incx], y, a + i * lda);
+    });
+}
+
+// ------------------------------------------------- Matrix<T> y std::vector<T>
+
+inline void check_blas_size(std::size_t expected, std::size_t got) {
+    if (expected != got) {
+        throw std::runtime_error("Vector size mismatch. Expected " + std::to_string(expected) + " elements, got " +
+                                 std::to_string(got) + ".");
+    }
+}
+
+template <typename T>
+T dot(const std::vector<T>& x, const std::vector<T>& y) {
+    check_blas_size(x.size(), y.size());
+    return dot(x.size(), x.data(), 1, y.data(), 1);
+}
+
+template <typename T>
+void axpy(T alpha, const std::vector<T>& x, std::vector<T>& y) {
+    check_blas_size(x.size(), y.size());
+    axpy(x.size(), alpha, x.data(), 1, y.data(), 1);
+}
+
+template <typename T>
+T nrm2(const std::vector<T>& x) {
+    return nrm2(x.size(), x.data(), 1);
+}
+
+template <typename T, typename Alloc>
+void gemv(T alpha, const Matrix<T, Alloc>& a, const std::vector<T>& x, T beta, std::vector<T>& y,
+          bool trans = false) {
+    check_blas_size(trans ? a.rows() : a.cols(), x.size());
+    check_blas_size(trans ? a.cols() : a.rows(), y.size());
+    gemv(trans, a.rows(), a.cols(), alpha, a.data(), a.ld(), x.data(), 1, beta, y.data(), 1);
+}
+
+template <typename T, typename Alloc>
+void ger(T alpha, const std::vector<T>& x, const std::vector<T>& y, Matrix<T, Alloc>& a) {
+    check_blas_size(a.rows(), x.size());
+    check_blas_size(a.cols(), y.size());
+    ger(a.rows(), a.cols(), alpha, x.data(), 1, y.data(), 1, a.data(), a.ld());
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "gemm_blocked.hpp"
+
+/*
+    Producto y traspuesta "cache-oblivious": divide y vencerás en orden Z
+    sobre la dimensión más grande hasta un bloque hoja de tamaño fijo. En
+    algún nivel de la recursión los subproblemas caben en L1, en otro en L2,
+    etc., sin conocer el tamaño de ninguna caché: no hay que ajustar tamaños
+    de bloque por máquina (a diferencia de gemm_blocking).
+
+    Todo es row-major con leading dimension (stride de columna 1).
+*/
+
+// Lado máximo del bloque hoja de la traspuesta: 2 bloques de 32 x 32
+// doubles caben en L1
+constexpr std::size_t recursive_leaf = 32;
+
+// Lado máximo del bloque hoja del producto. La hoja empaqueta sus trozos de
+// A y B y llama al micro-kernel SIMD (gemm_blocked con un único bloque); con
+// 128 copiar los paneles cuesta ~1/128 de los flops de la hoja. Con hojas
+// de 32 (bucle i-k-j sin empaquetar) no pasaba de 2 GFLOP/s.
+constexpr std::size_t recursive_gemm_leaf = 128;
+
+// C += alpha * A * B partiendo por la mitad la mayor de m, n, k
+template <typename T>
+void gemm_recursive_add(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                        const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb,
+                        T* c, std::ptrdiff_t ldc, const micro_kernel<T>& kernel) {
+    if (m <= recursive_gemm_leaf && n <= recursive_gemm_leaf && k <= recursive_gemm_leaf) {
+        gemm_blocked<T>(m, n, k, alpha, a, lda, 1, b, ldb, 1, T(1), c, ldc, 1, kernel);
+    } else if (m >= n && m >= k) {
+        const std::size_t h = m / 2;
+        gemm_recursive_add(h, n, k, alpha, a, lda, b, ldb, c, ldc, kernel);
+        gemm_recursive_add(m - h, n, k, alpha, a + h * lda, lda, b, ldb, c + h * ldc, ldc, kernel);
+    } else if (n >= k) {
+        const std::size_t h = n / 2;
+        gemm_recursive_add(m, h, k, alpha, a, lda, b, ldb, c, ldc, kernel);
+        gemm_recursive_add(m, n - h, k, alpha, a, lda, b + h, ldb, c + h, ldc, kernel);
+    } else {
+        // las dos mitades de k acumulan sobre el mismo C, una tras otra
+        const std::size_t h = k / 2;
+        gemm_recursive_add(m, n, h, alpha, a, lda, b, ldb, c, ldc, kernel);
+        gemm_recursive_add(m, n, k - h, alpha, a + h, lda, b + h * ldb, ldb, c, ldc, kernel);
+    }
+}
+
+// C = alpha * A * B + beta * C     A: m x k, B: k x n, C: m x n
+template <typename T>
+void gemm_recursive(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                    const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb,
+                    T beta, T* c, std::ptrdiff_t ldc,
+                    const micro_kernel<T>& kernel = default_micro_kernel<T>()) {
+    if (m == 0 || n == 0) return;
+    if (beta != T(1)) gemm_scale_c(m, n, beta, c, ldc, 1);
+    if (k == 0 || alpha == T(0)) return;
+    gemm_recursive_add(m, n, k, alpha, a, lda, b, ldb, c, ldc, kernel);
+}
+
+// dst (cols x rows) = src^T (rows x cols), sin solape entre src y dst
+template <typename T>
+void transpose_recursive(std::size_t rows, std::size_t cols, const T* src, std::ptrdiff_t lds,
+                         T* dst, std::ptrdiff_t ldd) {
+    if (rows <= recursive_leaf && cols <= recursive_leaf) {
+        for (std::size_t i = 0; i < rows; i++) {
+            for (std::size_t j = 0; j < cols; j++) dst[j * ldd + i] = src[i * lds + j];
+        }
+    } else if (rows >= cols) {
+        const std::size_t h = rows / 2;
+        transpose_recursive(h, cols, src, lds, dst, ldd);
+        transpose_recursive(rows - h, cols, src + h * lds, lds, dst + h, ldd);
+    } else {
+        const std::size_t h = cols / 2;
+        transpose_recursive(rows, h, src, lds, dst, ldd);
+        transpose_recursive(rows, cols - h, src + h, lds, dst + h * ldd, ldd);
+    }
+}
+
+// Intercambia el bloque p (rows x cols) con la traspuesta del bloque q
+// (cols x rows): p[i][j] <-> q[j][i]. Son los dos bloques fuera de la
+// diagonal de una matriz cuadrada.
+template <typename T>
+void transpose_swap_recursive(std::size_t rows, std::size_t cols, T* p, T* q, std::ptrdiff_t ld) {
+    if (rows <= recursive_leaf && cols <= recursive_leaf) {
+        for (std::size_t i = 0; i < rows; i++) {
+            for (std::size_t j = 0; j < cols; j++) std::swap(p[i * ld + j], q[j * ld + i]);
+        }
+    } else if (rows >= cols) {
+        const std::size_t h = rows / 2;
+        transpose_swap_recursive(h, cols, p, q, ld);
+        transpose_swap_recursive(rows - h, cols, p + h * ld, q + h, ld);
+    } else {
+        const std::size_t h = cols / 2;
+        transpose_swap_recursive(rows, h, p, q, ld);
+        transpose_swap_recursive(rows, cols - h, p + h, q + h * ld, ld);
+    }
+}
+
+// Traspuesta en sitio de una matriz n x n: los bloques diagonales se
+// trasponen por recursión y los de fuera se intercambian entre sí
+template <typename T>
+void transpose_square_in_place(std::size_t n, T* a, std::ptrdiff_t ld) {
+    if (n <= recursive_leaf) {
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = i + 1; j < n; j++) std::swap(a[i * ld + j], a[j * ld + i]);
+        }
+        return;
+    }
+    const std::size_t h = n / 2;
+    transpose_square_in_place(h, a, ld);
+    transpose_square_in_place(n - h, a + h * ld + h, ld);
+    transpose_swap_recursive(h, n - h, a + h, a + h * ld, ld);
+}
+
+/*
+    Traspuesta en sitio de una matriz rows x cols contigua (ld == cols); el
+    resultado es cols x rows contigua. Si es cuadrada se usa la versión
+    recursiva; si no, se siguen los ciclos de la permutación
+    pos -> pos * rows mod (count - 1), marcando los elementos ya movidos
+    (un bit por elemento).
+*/
+template <typename T>
+void transpose_in_place(std::size_t rows, std::size_t cols, T* a) {
+    if (rows == cols) {
+        transpose_square_in_place(rows, a, std::ptrdiff_t(cols));
+        return;
+    }
+    const std::size_t count = rows * cols;
+    if (count < 3) return;  // 1 x n o n x 1 con n <= 2: nada que mover
+
+    std::vector<bool> moved(count, false);
+    const std::size_t last = count - 1;  // 0 y count-1 no se mueven
+    for (std::size_t start = 1; start < last; start++) {
+        if (moved[start]) continue;
+        // el elemento en `pos` (fila i, col j) va a j * rows + i
+        std::size_t pos = start;
+        T value = a[start];
+        do {
+            const std::size_t next = (pos * rows) % last;
+            std::swap(value, a[next]);
+            moved[next] = true;
+            pos = next;
+        } while (pos != start);
+    }
+}
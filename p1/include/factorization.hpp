@@ -0,0 +1,384 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "blas.hpp"
+#include "gemm_blocked.hpp"
+#include "matrix.hpp"
+#include "simd_kernels.hpp"
+#include "task_graph.hpp"
+
+/*
+    Factorizaciones densas sobre Matrix<T> (row-major con leading dimension):
+
+        lu_factor        P A = L U con pivotaje parcial (L con diagonal unidad)
+        cholesky_factor  A = L L^T con A simétrica definida positiva
+        trsm_left        B = T^-1 B con T triangular
+        lu_solve, cholesky_solve, solve_triangular   sistemas A X = B
+
+    Las dos factorizaciones son "right-looking" por bloques de factor_block
+    columnas: factorizar el panel, resolver el triángulo (trsm) y restar el
+    producto al resto de la matriz con gemm_blocked y el micro-kernel SIMD.
+    Para n >> factor_block casi todos los FLOPs están en ese producto (nivel
+    3). El panel, el trsm y el bloque diagonal de Cholesky también son
+    recursivos (mitad izquierda, actualización con GEMM, mitad derecha) hasta
+    factor_leaf columnas, así que su parte de nivel 2 es pequeña.
+
+    El paralelismo es un grafo de tareas por bloques (task_graph) sobre el
+    pool compartido, con las dependencias de datos reales:
+        LU        panel(k) -> actualización(k, j) de cada bloque de columnas
+                  j > k; panel(k + 1) solo espera a actualización(k, k + 1)
+        Cholesky  potrf(k) -> trsm(k, i) -> gemm(k, i, j) por bloques
+                  i >= j > k del triángulo inferior
+    de modo que el panel siguiente se factoriza mientras se termina de
+    actualizar el resto (look-ahead) sin barreras entre pasos.
+*/
+
+// Lado de los bloques del grafo de tareas
+constexpr std::size_t factor_block = 128;
+
+// Por debajo de este lado las recursiones (panel, trsm, potrf) usan el
+// bucle directo
+constexpr std::size_t factor_leaf = 16;
+
+// ---------------------------------------------------------------- trsm
+
+/*
+    B = T^-1 B     T: m x m triangular inferior (lower) o superior, con
+    diagonal unidad si unit; B: m x n con filas contiguas. T se lee con
+    strides (rst, cst), así que T = L^T se pasa como (1, ld) de L.
+*/
+template <typename T>
+void trsm_left(bool lower, bool unit, std::size_t m, std::size_t n, const T* t, std::ptrdiff_t rst,
+               std::ptrdiff_t cst, T* b, std::ptrdiff_t ldb) {
+    if (m == 0 || n == 0) return;
+    if (m <= factor_leaf) {
+        // sustitución hacia delante (o hacia atrás) fila a fila
+        for (std::size_t s = 0; s < m; s++) {
+            const std::size_t i = lower ? s : m - 1 - s;
+            const std::size_t first = lower ? 0 : i + 1, last = lower ? i : m;
+            T* bi = b + i * ldb;
+            for (std::size_t p = first; p < last; p++) blas_axpy_kernel(n, -t[i * rst + p * cst], b + p * ldb, bi);
+            if (!unit) {
+                const T d = T(1) / t[i * rst + i * cst];
+                for (std::size_t j = 0; j < n; j++) bi[j] *= d;
+            }
+        }
+        return;
+    }
+    const std::size_t h = m / 2;
+    const T* t22 = t + h * rst + h * cst;
+    T* b2 = b + h * ldb;
+    if (lower) {
+        trsm_left(lower, unit, h, n, t, rst, cst, b, ldb);
+        gemm_blocked<T>(m - h, n, h, T(-1), t + h * rst, rst, cst, b, ldb, 1, T(1), b2, ldb, 1,
+                        simd_micro_kernel<T>());
+        trsm_left(lower, unit, m - h, n, t22, rst, cst, b2, ldb);
+    } else {
+        trsm_left(lower, unit, m - h, n, t22, rst, cst, b2, ldb);
+        gemm_blocked<T>(h, n, m - h, T(-1), t + h * cst, rst, cst, b2, ldb, 1, T(1), b, ldb, 1,
+                        simd_micro_kernel<T>());
+        trsm_left(lower, unit, h, n, t, rst, cst, b, ldb);
+    }
+}
+
+// B = B L^-T     L: n x n triangular inferior, B: m x n (el trsm de Cholesky)
+template <typename T>
+void trsm_right_lower_trans(std::size_t m, std::size_t n, const T* l, std::ptrdiff_t ldl, T* b, std::ptrdiff_t ldb) {
+    if (m == 0 || n == 0) return;
+    if (n <= factor_leaf) {
+        for (std::size_t r = 0; r < m; r++) {
+            T* br = b + r * ldb;
+            for (std::size_t j = 0; j < n; j++) {
+                br[j] = (br[j] - blas_dot_kernel(j, br, l + j * ldl)) / l[j * ldl + j];
+            }
+        }
+        return;
+    }
+    // [X1 X2] [L11^T L21^T; 0 L22^T] = [B1 B2]
+    const std::size_t h = n / 2;
+    trsm_right_lower_trans(m, h, l, ldl, b, ldb);
+    gemm_blocked<T>(m, n - h, h, T(-1), b, ldb, 1, l + h * ldl, 1, ldl, T(1), b + h, ldb, 1,
+                    simd_micro_kernel<T>());
+    trsm_right_lower_trans(m, n - h, l + h * ldl + h, ldl, b + h, ldb);
+}
+
+// ------------------------------------------------------------------- LU
+
+/*
+    Intercambios de filas de un panel: la fila base + i se cambia por la
+    piv[i] (índices globales, i < count). a apunta a la fila global base y
+    solo se tocan sus columnas [0, cols).
+*/
+template <typename T>
+void lu_swap_rows(T* a, std::ptrdiff_t lda, std::size_t cols, const std::size_t* piv, std::size_t count,
+                  std::size_t base) {
+    for (std::size_t i = 0; i < count; i++) {
+        const std::size_t r = piv[i] - base;
+        if (r != i) std::swap_ranges(a + i * lda, a + i * lda + cols, a + r * lda);
+    }
+}
+
+/*
+    LU recursiva con pivotaje parcial de un panel m x w (m >= w) cuya
+    esquina superior izquierda es el elemento diagonal global base. Guarda
+    en piv los pivotes globales y aplica los intercambios a las w columnas
+    del panel. Devuelve la primera columna (global) con pivote nulo, o
+    task_graph::none.
+*/
+template <typename T>
+std::size_t lu_panel(std::size_t m, std::size_t w, T* a, std::ptrdiff_t lda, std::size_t* piv, std::size_t base) {
+    if (w <= factor_leaf) {
+        std::size_t zero = task_graph::none;
+        for (std::size_t c = 0; c < w; c++) {
+            std::size_t p = c;
+            T best = std::abs(a[c * lda + c]);
+            for (std::size_t r = c + 1; r < m; r++) {
+                if (std::abs(a[r * lda + c]) > best) {
+                    best = std::abs(a[r * lda + c]);
+                    p = r;
+                }
+            }
+            piv[c] = base + p;
+            if (p != c) std::swap_ranges(a + c * lda, a + c * lda + w, a + p * lda);
+            const T d = a[c * lda + c];
+            if (d == T(0)) {
+                zero = std::min(zero, base + c);
+                continue;
+            }
+            // columna de L y actualización de rango 1 del resto del panel
+            for (std::size_t r = c + 1; r < m; r++) {
+                T* ar = a + r * lda;
+                ar[c] /= d;
+                blas_axpy_kernel(w - c - 1, -ar[c], a + c * lda + c + 1, ar + c + 1);
+            }
+        }
+        return zero;
+    }
+    const std::size_t h = w / 2;
+    std::size_t zero = lu_panel(m, h, a, lda, piv, base);
+    lu_swap_rows(a + h, lda, w - h, piv, h, base);
+    trsm_left(true, true, h, w - h, a, lda, 1, a + h, lda);
+    gemm_blocked<T>(m - h, w - h, h, T(-1), a + h * lda, lda, 1, a + h, lda, 1, T(1), a + h * lda + h, lda, 1,
+                    simd_micro_kernel<T>());
+    zero = std::min(zero, lu_panel(m - h, w - h, a + h * lda + h, lda, piv + h, base + h));
+    lu_swap_rows(a + h * lda, lda, h, piv + h, w - h, base + h);
+    return zero;
+}
+
+/*
+    P A = L U en sitio: a queda con L (sin la diagonal unidad) bajo la
+    diagonal y U en el resto. Devuelve los pivotes al estilo LAPACK: la
+    fila i se intercambió con piv[i] (>= i), en orden creciente de i.
+*/
+template <typename T, typename Alloc>
+std::vector<std::size_t> lu_factor(Matrix<T, Alloc>& a, std::size_t nb = factor_block) {
+    if (a.rows() != a.cols()) {
+        throw std::runtime_error("LU factorization needs a square matrix.");
+    }
+    const std::size_t n = a.rows(), ld = a.ld();
+    T* p = a.data();
+    nb = std::max<std::size_t>(1, nb);
+    const std::size_t nt = (n + nb - 1) / nb;
+    std::vector<std::size_t> piv(n);
+    std::size_t* ip = piv.data();
+    // Lo escriben solo los paneles, que se ejecutan uno tras otro
+    std::size_t zero = task_graph::none;
+
+    task_graph graph;
+    // Última tarea que escribió cada bloque de columnas
+    std::vector<std::size_t> last(nt, task_graph::none);
+    for (std::size_t k = 0; k < nt; k++) {
+        const std::size_t j0 = k * nb, w = std::min(nb, n - j0);
+        last[k] = graph.add([=, &zero] {
+            zero = std::min(zero, lu_panel(n - j0, w, p + j0 * ld + j0, ld, ip + j0, j0));
+        }, {last[k]});
+
+        for (std::size_t j = k + 1; j < nt; j++) {
+            const std::size_t c0 = j * nb, cw = std::min(nb, n - c0);
+            last[j] = graph.add([=] {
+                T* top = p + j0 * ld + c0;  // U12 de este bloque de columnas
+                lu_swap_rows(top, ld, cw, ip + j0, w, j0);
+                trsm_left(true, true, w, cw, p + j0 * ld + j0, ld, 1, top, ld);
+                gemm_blocked<T>(n - j0 - w, cw, w, T(-1), p + (j0 + w) * ld + j0, ld, 1, top, ld, 1,
+                                T(1), top + w * ld, ld, 1, simd_micro_kernel<T>());
+            }, {last[k], last[j]});
+        }
+    }
+    // Intercambios de los paneles posteriores sobre las columnas de L de
+    // cada bloque. Cuando termina el último panel ya han terminado todas
+    // las actualizaciones (lo preceden en el grafo), así que nadie más lee
+    // ni escribe esas columnas.
+    const std::size_t done = nt > 0 ? last[nt - 1] : task_graph::none;
+    for (std::size_t k = 0; k + 1 < nt; k++) {
+        const std::size_t j0 = k * nb, w = nb, r0 = j0 + w;
+        graph.add([=] { lu_swap_rows(p + r0 * ld + j0, ld, w, ip + r0, n - r0, r0); }, {done});
+    }
+    graph.run();
+
+    if (zero != task_graph::none) {
+        throw std::runtime_error("Matrix is singular: zero pivot in column " + std::to_string(zero) + ".");
+    }
+    return piv;
+}
+
+// ------------------------------------------------------------- Cholesky
+
+// A = L L^T recursiva sobre el triángulo inferior de a (n x n). Devuelve
+// false si a no es definida positiva.
+template <typename T>
+bool potrf_recursive(std::size_t n, T* a, std::ptrdiff_t lda) {
+    if (n <= factor_leaf) {
+        for (std::size_t j = 0; j < n; j++) {
+            T* aj = a + j * lda;
+            const T d = aj[j] - blas_dot_kernel(j, aj, aj);
+            if (!(d > T(0))) return false;  // también NaN
+            aj[j] = std::sqrt(d);
+            for (std::size_t i = j + 1; i < n; i++) {
+                T* ai = a + i * lda;
+                ai[j] = (ai[j] - blas_dot_kernel(j, ai, aj)) / aj[j];
+            }
+        }
+        return true;
+    }
+    const std::size_t h = n / 2;
+    if (!potrf_recursive(h, a, lda)) return false;
+    T* a21 = a + h * lda;
+    trsm_right_lower_trans(n - h, h, a, lda, a21, lda);
+    // A22 -= L21 L21^T (el cuadrado entero: el triángulo superior se descarta)
+    gemm_blocked<T>(n - h, n - h, h, T(-1), a21, lda, 1, a21, 1, lda, T(1), a21 + h, lda, 1,
+                    simd_micro_kernel<T>());
+    return potrf_recursive(n - h, a21 + h, lda);
+}
+
+/*
+    A = L L^T en sitio: a queda con L y la parte estrictamente superior a
+    cero. Solo se lee el triángulo inferior de a.
+*/
+template <typename T, typename Alloc>
+void cholesky_factor(Matrix<T, Alloc>& a, std::size_t nb = factor_block) {
+    if (a.rows() != a.cols()) {
+        throw std::runtime_error("Cholesky factorization needs a square matrix.");
+    }
+    const std::size_t n = a.rows(), ld = a.ld();
+    T* p = a.data();
+    nb = std::max<std::size_t>(1, nb);
+    const std::size_t nt = (n + nb - 1) / nb;
+    auto tile = [=](std::size_t i, std::size_t j) { return p + i * nb * ld + j * nb; };
+    auto side = [=](std::size_t i) { return std::min(nb, n - i * nb); };
+    // Lo escriben solo los potrf, que se ejecutan uno tras otro
+    bool positive = true;
+
+    task_graph graph;
+    // Última tarea que escribió cada bloque (i, j), i >= j
+    std::vector<std::size_t> last(nt * nt, task_graph::none);
+    for (std::size_t k = 0; k < nt; k++) {
+        const std::size_t tk = side(k);
+        last[k * nt + k] = graph.add([=, &positive] {
+            if (!potrf_recursive(tk, tile(k, k), ld)) positive = false;
+        }, {last[k * nt + k]});
+
+        for (std::size_t i = k + 1; i < nt; i++) {
+            last[i * nt + k] = graph.add([=] {
+                trsm_right_lower_trans(side(i), tk, tile(k, k), ld, tile(i, k), ld);
+            }, {last[k * nt + k], last[i * nt + k]});
+        }
+        for (std::size_t i = k + 1; i < nt; i++) {
+            for (std::size_t j = k + 1; j <= i; j++) {
+                // A(i, j) -= L(i, k) L(j, k)^T
+                last[i * nt + j] = graph.add([=] {
+                    gemm_blocked<T>(side(i), side(j), tk, T(-1), tile(i, k), ld, 1, tile(j, k), 1, ld,
+                                    T(1), tile(i, j), ld, 1, simd_micro_kernel<T>());
+                }, {last[i * nt + k], last[j * nt + k], last[i * nt + j]});
+            }
+        }
+    }
+    graph.run();
+
+    if (!positive) {
+        throw std::runtime_error("Matrix is not positive definite.");
+    }
+    for (std::size_t i = 0; i < n; i++) std::fill(p + i * ld + i + 1, p + i * ld + n, T(0));
+}
+
+// ------------------------------------------------------------- sistemas
+
+// f(c0, cw) por bloques de factor_block columnas de B, en paralelo
+template <typename F>
+void factor_for_columns(std::size_t cols, F f) {
+    if (cols <= factor_block) {
+        f(std::size_t(0), cols);
+        return;
+    }
+    task_graph graph;
+    for (std::size_t c0 = 0; c0 < cols; c0 += factor_block) {
+        const std::size_t cw = std::min(factor_block, cols - c0);
+        graph.add([&f, c0, cw] { f(c0, cw); });
+    }
+    graph.run();
+}
+
+template <typename T, typename AllocT, typename AllocB>
+void check_solve_size(const Matrix<T, AllocT>& t, const Matrix<T, AllocB>& b) {
+    if (t.rows() != t.cols() || b.rows() != t.rows()) {
+        throw std::runtime_error("Matrix size mismatch in solve.");
+    }
+}
+
+// B = T^-1 B con T triangular (inferior si lower, diagonal unidad si unit)
+template <typename T, typename AllocT, typename AllocB>
+void solve_triangular(const Matrix<T, AllocT>& t, Matrix<T, AllocB>& b, bool lower, bool unit = false) {
+    check_solve_size(t, b);
+    const std::size_t n = t.rows();
+    factor_for_columns(b.cols(), [&](std::size_t c0, std::size_t cw) {
+        trsm_left(lower, unit, n, cw, t.data(), t.ld(), 1, b.data() + c0, b.ld());
+    });
+}
+
+// B = A^-1 B a partir de lu_factor(A)
+template <typename T, typename AllocT, typename AllocB>
+void lu_solve(const Matrix<T, AllocT>& lu, const std::vector<std::size_t>& piv, Matrix<T, AllocB>& b) {
+    check_solve_size(lu, b);
+    if (piv.size() != lu.rows()) {
+        throw std::runtime_error("Pivot vector size mismatch in solve.");
+    }
+    const std::size_t n = lu.rows();
+    factor_for_columns(b.cols(), [&](std::size_t c0, std::size_t cw) {
+        T* bc = b.data() + c0;
+        lu_swap_rows(bc, b.ld(), cw, piv.data(), n, 0);
+        trsm_left(true, true, n, cw, lu.data(), lu.ld(), 1, bc, b.ld());
+        trsm_left(false, false, n, cw, lu.data(), lu.ld(), 1, bc, b.ld());
+    });
+}
+
+template <typename T, typename Alloc>
+void lu_solve(const Matrix<T, Alloc>& lu, const std::vector<std::size_t>& piv, std::vector<T>& b) {
+    Matrix<T> x(b.size(), 1);
+    x.fill(b);
+    lu_solve(lu, piv, x);
+    b.assign(x.data(), x.data() + x.count());
+}
+
+// B = A^-1 B a partir de cholesky_factor(A): L y después L^T
+template <typename T, typename AllocT, typename AllocB>
+void cholesky_solve(const Matrix<T, AllocT>& l, Matrix<T, AllocB>& b) {
+    check_solve_size(l, b);
+    const std::size_t n = l.rows();
+    factor_for_columns(b.cols(), [&](std::size_t c0, std::size_t cw) {
+        T* bc = b.data() + c0;
+        trsm_left(true, false, n, cw, l.data(), l.ld(), 1, bc, b.ld());
+        trsm_left(false, false, n, cw, l.data(), 1, l.ld(), bc, b.ld());
+    });
+}
+
+template <typename T, typename Alloc>
+void cholesky_solve(const Matrix<T, Alloc>& l, std::vector<T>& b) {
+    Matrix<T> x(b.size(), 1);
+    x.fill(b);
+    cholesky_solve(l, x);
+    b.assign(x.data(), x.data() + x.count());
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include "random_fill.hpp"
+#include "simd_kernels.hpp"
+#include "thread_pool.hpp"
+
+/*
+    Matrices pequeñas (4x4 ... 32x32) con dimensiones en tiempo de compilación.
+
+    FixedMatrix<T, R, C> guarda sus R*C elementos dentro del propio objeto
+    (sin reservar memoria) y el producto tiene todos los límites de los
+    bucles constantes, así que el compilador los desenrolla y vectoriza.
+
+    Lotes de muchos productos del mismo tamaño en una sola llamada:
+
+    - gemm_batched_strided: matrices row-major separadas por un stride. Cada
+      producto usa el kernel de tamaño fijo compilado para la ISA activa
+      (una fila de C en registros, vectorizada a lo largo de la fila).
+
+    - gemm_batched_interleaved: formato intercalado, SIMD a lo largo del lote
+      (cada carril es una matriz distinta):
+
+        elemento (i, j) de la matriz l del grupo g -> p[g*R*C*W + (i*C + j)*W + l]
+
+      con W = batch_lanes<T> matrices por grupo (64 bytes: 8 double, 16
+      float). Es lo más rápido para tamaños muy pequeños o impares (3x3,
+      5x5), donde una fila no llena un vector, pero solo compensa si los
+      datos ya viven en ese formato: intercalar en cada llamada
+      (batch_interleave) cuesta más que el propio producto.
+*/
+
+// C = A * B para una matriz (M x K) * (K x N) row-major. Orden i-k-j: el
+// bucle interno recorre una fila de B y otra de C con longitud constante, que
+// el compilador desenrolla y vectoriza con el ancho de la ISA del llamador.
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+__attribute__((always_inline)) inline void fixed_gemm_kernel(const T* __restrict a, const T* __restrict b,
+                                                             T* __restrict c) {
+    for (std::size_t i = 0; i < M; i++) {
+        T row[N] = {};
+#pragma GCC unroll 32
+        for (std::size_t p = 0; p < K; p++) {
+            const T aip = a[i * K + p];
+#pragma GCC unroll 32
+            for (std::size_t j = 0; j < N; j++) row[j] += aip * b[p * N + j];
+        }
+        for (std::size_t j = 0; j < N; j++) c[i * N + j] = row[j];
+    }
+}
+
+template <typename T, std::size_t Rows, std::size_t Cols = Rows>
+class FixedMatrix {
+    T m[Rows * Cols];
+
+public:
+    using value_type = T;
+    static constexpr std::size_t rows() { return Rows; }
+    static constexpr std::size_t cols() { return Cols; }
+    static constexpr std::size_t count() { return Rows * Cols; }
+
+    FixedMatrix() = default;
+
+    explicit FixedMatrix(T value) { fill(value); }
+
+    T& operator()(std::size_t i, std::size_t j) { return m[i * Cols + j]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return m[i * Cols + j]; }
+    T* data() { return m; }
+    const T* data() const { return m; }
+
+    void fill(T value) { std::fill(m, m + count(), value); }
+
+    void fill_random(T min_value = 1.0, T max_value = 100.0, uint64_t seed = random_seed()) {
+        philox::uniform(seed, 0, count(), min_value, T(max_value - min_value), m);
+    }
+
+    static FixedMatrix identity() {
+        FixedMatrix r(T(0));
+        for (std::size_t i = 0; i < std::min(Rows, Cols); i++) r(i, i) = T(1);
+        return r;
+    }
+
+    FixedMatrix& operator+=(const FixedMatrix& o) {
+        for (std::size_t i = 0; i < count(); i++) m[i] += o.m[i];
+        return *this;
+    }
+
+    FixedMatrix& operator-=(const FixedMatrix& o) {
+        for (std::size_t i = 0; i < count(); i++) m[i] -= o.m[i];
+        return *this;
+    }
+
+    FixedMatrix& operator*=(T s) {
+        for (std::size_t i = 0; i < count(); i++) m[i] *= s;
+        return *this;
+    }
+
+    friend FixedMatrix operator+(FixedMatrix a, const FixedMatrix& b) { return a += b; }
+    friend FixedMatrix operator-(FixedMatrix a, const FixedMatrix& b) { return a -= b; }
+    friend FixedMatrix operator*(FixedMatrix a, T s) { return a *= s; }
+    friend FixedMatrix operator*(T s, FixedMatrix a) { return a *= s; }
+
+    template <std::size_t N>
+    friend FixedMatrix<T, Rows, N> operator*(const FixedMatrix& a, const FixedMatrix<T, Cols, N>& b) {
+        FixedMatrix<T, Rows, N> c;
+        fixed_gemm_kernel<T, Rows, Cols, N>(a.data(), b.data(), c.data());
+        return c;
+    }
+
+    void print() const {
+        for (std::size_t i = 0; i < Rows; i++) {
+            for (std::size_t j = 0; j < Cols; j++) std::cout << (*this)(i, j) << " ";
+            std::cout << std::endl;
+        }
+    }
+};
+
+// ---------------------------------------------------------------- lotes
+
+template <typename T>
+constexpr std::size_t batch_lanes() { return 64 / sizeof(T); }
+
+// Por encima de este número de FLOPs el lote se reparte entre los hilos del pool
+constexpr double batched_parallel_flops = 1 << 24;
+
+// Fila i, columnas [j0, j0 + JB) de C para un grupo de W productos en formato
+// intercalado. Cada acumulador es un vector de W carriles (uno por matriz);
+// JB columnas a la vez dan JB cadenas de FMAs independientes y reutilizan la
+// carga de A.
+template <typename T, std::size_t M, std::size_t K, std::size_t N, std::size_t JB>
+__attribute__((always_inline)) inline void batch_row_block(const T* __restrict a, const T* __restrict b,
+                                                           T* __restrict c, std::size_t i, std::size_t j0) {
+    constexpr std::size_t W = batch_lanes<T>();
+    T acc[JB][W] = {};
+#pragma GCC unroll 32
+    for (std::size_t p = 0; p < K; p++) {
+        const T* ap = a + (i * K + p) * W;
+#pragma GCC unroll 4
+        for (std::size_t jj = 0; jj < JB; jj++) {
+            const T* bp = b + (p * N + j0 + jj) * W;
+            for (std::size_t l = 0; l < W; l++) acc[jj][l] += ap[l] * bp[l];
+        }
+    }
+#pragma GCC unroll 4
+    for (std::size_t jj = 0; jj < JB; jj++) {
+        T* cp = c + (i * N + j0 + jj) * W;
+        for (std::size_t l = 0; l < W; l++) cp[l] = acc[jj][l];
+    }
+}
+
+// Un grupo de W productos (M x K) * (K x N)
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+__attribute__((always_inline)) inline void batch_group_kernel(const T* __restrict a, const T* __restrict b,
+                                                              T* __restrict c) {
+    for (std::size_t i = 0; i < M; i++) {
+        std::size_t j = 0;
+        for (; j + 4 <= N; j += 4) batch_row_block<T, M, K, N, 4>(a, b, c, i, j);
+        for (; j < N; j++) batch_row_block<T, M, K, N, 1>(a, b, c, i, j);
+    }
+}
+
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+void batch_groups_generic(std::size_t groups, const T* a, std::ptrdiff_t ga, const T* b, std::ptrdiff_t gb, T* c) {
+    for (std::size_t g = 0; g < groups; g++) {
+        batch_group_kernel<T, M, K, N>(a + g * ga, b + g * gb, c + g * M * N * batch_lanes<T>());
+    }
+}
+
+#if PACS_SIMD_X86
+// Misma función compilada para cada ISA; el bucle de carriles se vectoriza con su ancho.
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+__attribute__((target("avx2,fma")))
+void batch_groups_avx2(std::size_t groups, const T* a, std::ptrdiff_t ga, const T* b, std::ptrdiff_t gb, T* c) {
+    for (std::size_t g = 0; g < groups; g++) {
+        batch_group_kernel<T, M, K, N>(a + g * ga, b + g * gb, c + g * M * N * batch_lanes<T>());
+    }
+}
+
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+__attribute__((target("avx512f")))
+void batch_groups_avx512(std::size_t groups, const T* a, std::ptrdiff_t ga, const T* b, std::ptrdiff_t gb, T* c) {
+    for (std::size_t g = 0; g < groups; g++) {
+        batch_group_kernel<T, M, K, N>(a + g * ga, b + g * gb, c + g * M * N * batch_lanes<T>());
+    }
+}
+#endif
+
+// ga / gb: distancia entre grupos de A y B (0 = el mismo operando para todo el lote)
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+void batch_groups(std::size_t groups, const T* a, std::ptrdiff_t ga, const T* b, std::ptrdiff_t gb, T* c) {
+#if PACS_SIMD_X86
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: batch_groups_avx512<T, M, K, N>(groups, a, ga, b, gb, c); return;
+        case simd_isa::avx2: batch_groups_avx2<T, M, K, N>(groups, a, ga, b, gb, c); return;
+        default: break;
+    }
+#endif
+    batch_groups_generic<T, M, K, N>(groups, a, ga, b, gb, c);
+}
+
+// Copia `count` matrices R x C (distancia `stride` entre ellas) al formato
+// intercalado; los carriles sobrantes del último grupo quedan a cero. Se
+// recorre por grupos para escribir cada vector de W carriles seguido.
+template <typename T, std::size_t R, std::size_t C>
+void batch_interleave(std::size_t count, const T* src, std::ptrdiff_t stride, T* dst) {
+    constexpr std::size_t W = batch_lanes<T>();
+    for (std::size_t l0 = 0; l0 < count; l0 += W) {
+        const std::size_t lanes = std::min(W, count - l0);
+        T* d = dst + (l0 / W) * R * C * W;
+        const T* s = src + l0 * stride;
+        for (std::size_t e = 0; e < R * C; e++) {
+            for (std::size_t l = 0; l < lanes; l++) d[e * W + l] = s[l * stride + e];
+            for (std::size_t l = lanes; l < W; l++) d[e * W + l] = T(0);
+        }
+    }
+}
+
+template <typename T, std::size_t R, std::size_t C>
+void batch_deinterleave(std::size_t count, const T* src, T* dst, std::ptrdiff_t stride) {
+    constexpr std::size_t W = batch_lanes<T>();
+    for (std::size_t l0 = 0; l0 < count; l0 += W) {
+        const std::size_t lanes = std::min(W, count - l0);
+        const T* s = src + (l0 / W) * R * C * W;
+        T* d = dst + l0 * stride;
+        for (std::size_t e = 0; e < R * C; e++) {
+            for (std::size_t l = 0; l < lanes; l++) d[l * stride + e] = s[e * W + l];
+        }
+    }
+}
+
+// `groups` grupos ya intercalados: C_g = A_g * B_g
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+void gemm_batched_interleaved(std::size_t groups, const T* a, const T* b, T* c) {
+    constexpr std::size_t W = batch_lanes<T>();
+    const double flops = 2.0 * M * N * K * W * groups;
+    thread_pool& pool = thread_pool::current();
+    if (flops < batched_parallel_flops || pool.size() == 1) {
+        batch_groups<T, M, K, N>(groups, a, M * K * W, b, K * N * W, c);
+        return;
+    }
+    const std::size_t chunk = (groups + pool.size() - 1) / pool.size();
+    for (std::size_t g0 = 0; g0 < groups; g0 += chunk) {
+        std::size_t n = std::min(chunk, groups - g0);
+        pool.submit([=] {
+            batch_groups<T, M, K, N>(n, a + g0 * M * K * W, M * K * W, b + g0 * K * N * W, K * N * W,
+                                     c + g0 * M * N * W);
+        });
+    }
+    pool.wait();
+}
+
+// C_l = A_l * B_l sobre `count` matrices con el kernel de tamaño fijo
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+void fixed_batch_generic(std::size_t count, const T* a, std::ptrdiff_t sa, const T* b, std::ptrdiff_t sb,
+                         T* c, std::ptrdiff_t sc) {
+    for (std::size_t l = 0; l < count; l++) fixed_gemm_kernel<T, M, K, N>(a + l * sa, b + l * sb, c + l * sc);
+}
+
+#if PACS_SIMD_X86
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+__attribute__((target("avx2,fma")))
+void fixed_batch_avx2(std::size_t count, const T* a, std::ptrdiff_t sa, const T* b, std::ptrdiff_t sb,
+                      T* c, std::ptrdiff_t sc) {
+    for (std::size_t l = 0; l < count; l++) fixed_gemm_kernel<T, M, K, N>(a + l * sa, b + l * sb, c + l * sc);
+}
+
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+__attribute__((target("avx512f")))
+void fixed_batch_avx512(std::size_t count, const T* a, std::ptrdiff_t sa, const T* b, std::ptrdiff_t sb,
+                        T* c, std::ptrdiff_t sc) {
+    for (std::size_t l = 0; l < count; l++) fixed_gemm_kernel<T, M, K, N>(a + l * sa, b + l * sb, c + l * sc);
+}
+#endif
+
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+void fixed_batch(std::size_t count, const T* a, std::ptrdiff_t sa, const T* b, std::ptrdiff_t sb,
+                 T* c, std::ptrdiff_t sc) {
+#if PACS_SIMD_X86
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: fixed_batch_avx512<T, M, K, N>(count, a, sa, b, sb, c, sc); return;
+        case simd_isa::avx2: fixed_batch_avx2<T, M, K, N>(count, a, sa, b, sb, c, sc); return;
+        default: break;
+    }
+#endif
+    fixed_batch_generic<T, M, K, N>(count, a, sa, b, sb, c, sc);
+}
+
+/*
+    C_l = A_l * B_l para l = 0 .. count-1, con cada matriz row-major densa y
+    `stride_*` elementos entre una matriz y la siguiente (stride_b = 0 usa la
+    misma B para todo el lote). Los lotes grandes se reparten entre los hilos
+    del pool.
+*/
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+void gemm_batched_strided(std::size_t count, const T* a, std::ptrdiff_t stride_a, const T* b,
+                          std::ptrdiff_t stride_b, T* c, std::ptrdiff_t stride_c) {
+    const double flops = 2.0 * M * N * K * count;
+    thread_pool& pool = thread_pool::current();
+    if (flops < batched_parallel_flops || pool.size() == 1) {
+        fixed_batch<T, M, K, N>(count, a, stride_a, b, stride_b, c, stride_c);
+        return;
+    }
+    const std::size_t chunk = (count + pool.size() - 1) / pool.size();
+    for (std::size_t first = 0; first < count; first += chunk) {
+        std::size_t n = std::min(chunk, count - first);
+        pool.submit([=] {
+            fixed_batch<T, M, K, N>(n, a + first * stride_a, stride_a, b + first * stride_b, stride_b,
+                                    c + first * stride_c, stride_c);
+        });
+    }
+    pool.wait();
+}
+
+// Lote de FixedMatrix contiguas
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+void multiply_batched(std::size_t count, const FixedMatrix<T, M, K>* a, const FixedMatrix<T, K, N>* b,
+                      FixedMatrix<T, M, N>* c) {
+    static_assert(sizeof(FixedMatrix<T, M, K>) == M * K * sizeof(T), "FixedMatrix must not be padded.");
+    gemm_batched_strided<T, M, K, N>(count, a->data(), M * K, b->data(), K * N, c->data(), M * N);
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "tuning_profile.hpp"
+
+/*
+    GEMM por bloques (esquema Goto / BLIS):
+
+        C = alpha * A * B + beta * C     A: m x k, B: k x n, C: m x n
+
+    Cada matriz se describe con un puntero y dos strides (fila y columna), asi
+    que el mismo motor sirve para row-major, column-major o traspuestas sin
+    copiar nada: el empaquetado lee con los strides y deja los paneles en el
+    orden que espera el micro-kernel.
+
+    A y B pueden guardarse en un tipo distinto del de cálculo T (p.ej.
+    bfloat16 o int8, ver mixed_precision.hpp): el empaquetado convierte cada
+    elemento a T, así que el micro-kernel y C siempre trabajan en T.
+
+    Bucles (de fuera a dentro):
+        jc: bloques de nc columnas de B   -> panel de B empaquetado vive en L3
+        pc: bloques de kc de profundidad  -> un micro-panel de B vive en L1
+        ic: bloques de mc filas de A      -> panel de A empaquetado vive en L2
+        jr, ir: micro-kernel mr x nr sobre registros
+*/
+
+// Tamaños de bloque para los tres niveles de caché.
+struct gemm_blocking {
+    std::size_t mc = 96;
+    std::size_t kc = 256;
+    std::size_t nc = 4096;
+};
+
+// Tamaños del perfil de ajuste de la máquina (tuning_profile.hpp) o, sin
+// perfil, los de arriba
+template <typename T>
+gemm_blocking& gemm_tuned_blocking() {
+    static gemm_blocking bs = [] {
+        gemm_blocking d;
+        d.mc = tuning_get_size<T>("mc", d.mc);
+        d.kc = tuning_get_size<T>("kc", d.kc);
+        d.nc = tuning_get_size<T>("nc", d.nc);
+        return d;
+    }();
+    return bs;
+}
+
+// Micro-kernel con el que se midieron los tamaños de gemm_tuned_blocking:
+// el <tipo>.kernel del perfil ("avx512 8x16", el nombre lleva la ISA), o
+// vacío si valen para cualquiera
+template <typename T>
+std::string& gemm_tuned_blocking_kernel() {
+    static std::string name = tuning_get<T>("kernel", "");
+    return name;
+}
+
+// Micro-kernel: c[mr x nr] = alpha * sum_p a[p*mr + i] * b[p*nr + j] + beta * c
+// Los paneles a y b vienen empaquetados (y rellenados con ceros en los bordes).
+// Si beta == 0 no se lee c.
+template <typename T>
+using micro_kernel_fn = void (*)(std::size_t kc, T alpha, const T* a, const T* b,
+                                 T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc);
+
+// Tamaño máximo de mr y nr: el borde de C se calcula en un buffer fijo de
+// gemm_max_micro_tile x gemm_max_micro_tile en la pila (gemm_macro_kernel)
+constexpr std::size_t gemm_max_micro_tile = 64;
+
+template <typename T>
+struct micro_kernel {
+    std::size_t mr;
+    std::size_t nr;
+    micro_kernel_fn<T> fn;
+    const char* name;
+};
+
+// Micro-kernel genérico en C++: el acumulador MR x NR es local y de tamaño
+// fijo, por lo que el compilador lo mantiene en registros.
+template <typename T, std::size_t MR, std::size_t NR>
+void micro_kernel_generic(std::size_t kc, T alpha, const T* a, const T* b,
+                          T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+    static_assert(MR > 0 && NR > 0 && MR <= gemm_max_micro_tile && NR <= gemm_max_micro_tile,
+                  "Micro-kernel tile does not fit the edge buffer of gemm_macro_kernel.");
+    T acc[MR][NR] = {};
+
+    for (std::size_t p = 0; p < kc; p++) {
+        for (std::size_t i = 0; i < MR; i++) {
+            T ai = a[p * MR + i];
+            for (std::size_t j = 0; j < NR; j++) {
+                acc[i][j] += ai * b[p * NR + j];
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < MR; i++) {
+        for (std::size_t j = 0; j < NR; j++) {
+            T& cij = c[i * rsc + j * csc];
+            cij = (beta == T(0)) ? alpha * acc[i][j] : alpha * acc[i][j] + beta * cij;
+        }
+    }
+}
+
+template <typename T>
+micro_kernel<T> default_micro_kernel() {
+    return {4, 8, &micro_kernel_generic<T, 4, 8>, "generic 4x8"};
+}
+
+// Empaqueta un bloque mc x kc de A en micro-paneles de mr filas (orden p-major).
+template <typename T, typename S>
+void pack_a(std::size_t mc, std::size_t kc, const S* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+            std::size_t mr, T* ap) {
+    for (std::size_t ir = 0; ir < mc; ir += mr) {
+        std::size_t rows = std::min(mr, mc - ir);
+        for (std::size_t p = 0; p < kc; p++) {
+            for (std::size_t i = 0; i < rows; i++) {
+                ap[p * mr + i] = static_cast<T>(a[(ir + i) * rsa + p * csa]);
+            }
+            for (std::size_t i = rows; i < mr; i++) {
+                ap[p * mr + i] = T(0);
+            }
+        }
+        ap += kc * mr;
+    }
+}
+
+// Empaqueta un bloque kc x nc de B en micro-paneles de nr columnas (orden p-major).
+template <typename T, typename S>
+void pack_b(std::size_t kc, std::size_t nc, const S* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+            std::size_t nr, T* bp) {
+    for (std::size_t jr = 0; jr < nc; jr += nr) {
+        std::size_t cols = std::min(nr, nc - jr);
+        for (std::size_t p = 0; p < kc; p++) {
+            for (std::size_t j = 0; j < cols; j++) {
+                bp[p * nr + j] = static_cast<T>(b[p * rsb + (jr + j) * csb]);
+            }
+            for (std::size_t j = cols; j < nr; j++) {
+                bp[p * nr + j] = T(0);
+            }
+        }
+        bp += kc * nr;
+    }
+}
+
+// mr y nr tienen que caber en el buffer de borde de gemm_macro_kernel
+template <typename T>
+void check_micro_kernel(const micro_kernel<T>& kernel) {
+    if (kernel.mr == 0 || kernel.nr == 0 || kernel.mr > gemm_max_micro_tile || kernel.nr > gemm_max_micro_tile) {
+        throw std::runtime_error(std::string("Micro-kernel ") + kernel.name + " must be between 1x1 and " +
+                                 std::to_string(gemm_max_micro_tile) + "x" + std::to_string(gemm_max_micro_tile) + ".");
+    }
+}
+
+// C = beta * C (caso k == 0 o alpha == 0).
+template <typename T>
+void gemm_scale_c(std::size_t m, std::size_t n, T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+    for (std::size_t i = 0; i < m; i++) {
+        for (std::size_t j = 0; j < n; j++) {
+            T& cij = c[i * rsc + j * csc];
+            cij = (beta == T(0)) ? T(0) : beta * cij;
+        }
+    }
+}
+
+// Bucles jr, ir sobre un panel de A (mc x kc) y uno de B (kc x nc) ya
+// empaquetados: C[mc x nc] = alpha * A * B + beta * C
+template <typename T>
+void gemm_macro_kernel(std::size_t mc, std::size_t nc, std::size_t kc, T alpha, const T* ap, const T* bp,
+                       T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc, const micro_kernel<T>& kernel) {
+    check_micro_kernel(kernel);
+    const std::size_t mr = kernel.mr, nr = kernel.nr;
+    T ctmp[gemm_max_micro_tile * gemm_max_micro_tile];  // borde del micro-kernel
+
+    for (std::size_t jr = 0; jr < nc; jr += nr) {
+        std::size_t cols = std::min(nr, nc - jr);
+        const T* bpanel = bp + jr * kc;
+
+        for (std::size_t ir = 0; ir < mc; ir += mr) {
+            std::size_t rows = std::min(mr, mc - ir);
+            const T* apanel = ap + ir * kc;
+            T* cij = c + ir * rsc + jr * csc;
+
+            if (rows == mr && cols == nr) {
+                kernel.fn(kc, alpha, apanel, bpanel, beta, cij, rsc, csc);
+            } else {
+                // Tile incompleto: se calcula en un buffer y se copia la parte válida.
+                kernel.fn(kc, alpha, apanel, bpanel, T(0), ctmp, nr, 1);
+                for (std::size_t i = 0; i < rows; i++) {
+                    for (std::size_t j = 0; j < cols; j++) {
+                        T& cv = cij[i * rsc + j * csc];
+                        cv = (beta == T(0)) ? ctmp[i * nr + j] : ctmp[i * nr + j] + beta * cv;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Tamaños que usa gemm_blocked si no se le pasan otros: los ajustados solo
+// si se midieron con este micro-kernel (con otra ISA u otra forma de
+// micro-kernel los paneles óptimos son otros), si no los de por defecto
+template <typename T>
+const gemm_blocking& gemm_blocking_for(const micro_kernel<T>& kernel) {
+    static const gemm_blocking defaults;
+    const std::string& tuned_for = gemm_tuned_blocking_kernel<T>();
+    return tuned_for.empty() || tuned_for == kernel.name ? gemm_tuned_blocking<T>() : defaults;
+}
+
+template <typename T, typename SA = T, typename SB = T>
+void gemm_blocked(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                  const SA* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+                  const SB* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+                  T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc,
+                  const micro_kernel<T>& kernel, const gemm_blocking& bs) {
+    if (m == 0 || n == 0) return;
+    if (k == 0 || alpha == T(0)) {
+        gemm_scale_c(m, n, beta, c, rsc, csc);
+        return;
+    }
+
+    check_micro_kernel(kernel);
+    const std::size_t mr = kernel.mr, nr = kernel.nr;
+    // mc y nc se redondean a múltiplos del micro-kernel.
+    const std::size_t mc_max = std::max(mr, bs.mc / mr * mr);
+    const std::size_t nc_max = std::max(nr, bs.nc / nr * nr);
+    const std::size_t kc_max = std::max<std::size_t>(1, bs.kc);
+
+    std::vector<T> ap(std::min(mc_max, (m + mr - 1) / mr * mr) * std::min(kc_max, k));
+    std::vector<T> bp(std::min(nc_max, (n + nr - 1) / nr * nr) * std::min(kc_max, k));
+
+    for (std::size_t jc = 0; jc < n; jc += nc_max) {
+        std::size_t nc = std::min(nc_max, n - jc);
+
+        for (std::size_t pc = 0; pc < k; pc += kc_max) {
+            std::size_t kc = std::min(kc_max, k - pc);
+            // beta solo se aplica en el primer bloque de profundidad
+            T beta_pc = (pc == 0) ? beta : T(1);
+
+            pack_b(kc, nc, b + pc * rsb + jc * csb, rsb, csb, nr, bp.data());
+
+            for (std::size_t ic = 0; ic < m; ic += mc_max) {
+                std::size_t mc = std::min(mc_max, m - ic);
+
+                pack_a(mc, kc, a + ic * rsa + pc * csa, rsa, csa, mr, ap.data());
+                gemm_macro_kernel(mc, nc, kc, alpha, ap.data(), bp.data(), beta_pc,
+                                  c + ic * rsc + jc * csc, rsc, csc, kernel);
+            }
+        }
+    }
+}
+
+template <typename T, typename SA = T, typename SB = T>
+void gemm_blocked(std::size_t m, std::size_t n, std::size_t k, T alpha,
+                  const SA* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+                  const SB* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+                  T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc,
+                  const micro_kernel<T>& kernel = default_micro_kernel<T>()) {
+    gemm_blocked<T>(m, n, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc, kernel,
+                    gemm_blocking_for<T>(kernel));
+}
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "aligned_allocator.hpp"
+#include "cache_oblivious.hpp"
+#include "gemm_blocked.hpp"
+#include "random_fill.hpp"
+#include "simd_kernels.hpp"
+#include "strassen.hpp"
+#include "tuning_profile.hpp"
+#include "matrix_expr.hpp"
+#include "matrix_view.hpp"
+
+// Algoritmo usado por los productos de Matrix<T>
+enum class mult_algorithm { naive, blocked, strassen, recursive };
+
+inline mult_algorithm parse_algorithm(const std::string& name) {
+    if (name == "naive") return mult_algorithm::naive;
+    if (name == "blocked") return mult_algorithm::blocked;
+    if (name == "strassen") return mult_algorithm::strassen;
+    if (name == "recursive") return mult_algorithm::recursive;
+    throw std::runtime_error("Unknown multiplication algorithm: " + name + ".");
+}
+
+inline const char* algorithm_name(mult_algorithm algorithm) {
+    switch (algorithm) {
+        case mult_algorithm::naive: return "naive";
+        case mult_algorithm::strassen: return "strassen";
+        case mult_algorithm::recursive: return "recursive";
+        default: return "blocked";
+    }
+}
+
+// Algoritmo del perfil de ajuste de la máquina (tuning_profile.hpp), o blocked
+template <typename T>
+mult_algorithm tuned_algorithm() {
+    try {
+        return parse_algorithm(tuning_get<T>("algorithm", "blocked"));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << " Using blocked." << std::endl;
+        return mult_algorithm::blocked;
+    }
+}
+
+// Configuración y despacho de los productos, común a todas las Matrix<T, Alloc>
+template <typename T>
+struct matrix_gemm {
+    // Seleccionable en tiempo de ejecución (por defecto, GEMM por bloques)
+    static mult_algorithm algorithm;
+    static unsigned int strassen_crossover;
+
+    // C = alpha * A * B + beta * C con el algoritmo seleccionado. Los strides
+    // permiten operandos traspuestos sin copiarlos.
+    static void gemm_raw(std::size_t rows, std::size_t cols, std::size_t k, T alpha,
+                         const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+                         const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+                         T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+        switch (algorithm) {
+            case mult_algorithm::strassen:
+                // Strassen solo cubre el caso cuadrado, row-major y sin escalar
+                if (rows == cols && cols == k && alpha == T(1) && beta == T(0) &&
+                    csa == 1 && csb == 1 && csc == 1) {
+                    strassen_winograd<T>(rows, a, rsa, b, rsb, c, rsc, strassen_crossover,
+                                         simd_micro_kernel<T>());
+                    return;
+                }
+                // fall through
+            case mult_algorithm::recursive:
+                // la recursión cache-oblivious trabaja sobre filas contiguas
+                if (algorithm == mult_algorithm::recursive && csa == 1 && csb == 1 && csc == 1) {
+                    gemm_recursive<T>(rows, cols, k, alpha, a, rsa, b, rsb, beta, c, rsc, simd_micro_kernel<T>());
+                    return;
+                }
+                // fall through
+            case mult_algorithm::blocked:
+                gemm_blocked<T>(rows, cols, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc,
+                                simd_micro_kernel<T>());
+                return;
+            default:
+                gemm_naive(rows, cols, k, alpha, a, rsa, csa, b, rsb, csb, beta, c, rsc, csc);
+        }
+    }
+
+    // Triple bucle i-j-k original
+    static void gemm_naive(std::size_t rows, std::size_t cols, std::size_t k, T alpha,
+                           const T* a, std::ptrdiff_t rsa, std::ptrdiff_t csa,
+                           const T* b, std::ptrdiff_t rsb, std::ptrdiff_t csb,
+                           T beta, T* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+        for (std::size_t i = 0; i < rows; i++) {
+            for (std::size_t j = 0; j < cols; j++) {
+                T sum = 0;
+                for (std::size_t p = 0; p < k; p++) {
+                    sum += a[i*rsa + p*csa] * b[p*rsb + j*csb];
+                }
+                T& cij = c[i*rsc + j*csc];
+                cij = (beta == T(0)) ? alpha * sum : alpha * sum + beta * cij;
+            }
+        }
+    }
+};
+
+template <typename T>
+mult_algorithm matrix_gemm<T>::algorithm = tuned_algorithm<T>();
+
+template <typename T>
+unsigned int matrix_gemm<T>::strassen_crossover = tuning_get_size<T>("strassen_crossover", 512);
+
+// Matriz rows x cols (n x n si se construye con un solo tamaño) en un único
+// arreglo row-major. El almacenamiento lo da Alloc (por defecto alineado a
+// 64 bytes; ver aligned_allocator.hpp). block/row_range/col_range devuelven
+// vistas sin copia (matrix_view.hpp) que se pueden usar en cualquier expresión.
+template <typename T, typename Alloc = aligned_allocator<T>>
+class Matrix : public matrix_expr<Matrix<T, Alloc>>, public matrix_gemm<T> {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "Matrix<T> stores T in raw allocator memory.");
+
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    std::size_t _rows, _cols;
+    T* m;
+    Alloc _alloc;
+
+    T* allocate(std::size_t count) { return count ? alloc_traits::allocate(_alloc, count) : nullptr; }
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    Matrix(unsigned int n, const Alloc& alloc = Alloc()) : Matrix(n, n, alloc) {}
+
+    Matrix(std::size_t rows, std::size_t cols, const Alloc& alloc = Alloc())
+        : _rows(rows), _cols(cols), m(nullptr), _alloc(alloc) {
+        m = allocate(count());
+    }
+
+    Matrix(const std::vector<T>& v, const Alloc& alloc = Alloc()) : m(nullptr), _alloc(alloc) {
+        _rows = _cols = std::sqrt(v.size());
+        if (count() != v.size()) {
+            throw std::runtime_error("Vector size must be a perfect square.");
+        }
+        m = allocate(count());
+        fill(v);
+    }
+
+    Matrix(const Matrix& other)
+        : _rows(other._rows), _cols(other._cols), m(nullptr),
+          _alloc(alloc_traits::select_on_container_copy_construction(other._alloc)) {
+        m = allocate(count());
+        std::copy(other.m, other.m + count(), m);
+    }
+
+    Matrix(Matrix&& other) noexcept
+        : _rows(other._rows), _cols(other._cols), m(other.m), _alloc(std::move(other._alloc)) {
+        other._rows = other._cols = 0;
+        other.m = nullptr;
+    }
+
+    // Evalúa una expresión (A*B + C, 2*A - B, ...) directamente en la nueva matriz
+    template <class E>
+    Matrix(const matrix_expr<E>& e) : Matrix(as_expr(e.self()).rows(), as_expr(e.self()).cols()) {
+        assign_expr(as_expr(e.self()), T(1), T(0), m, _cols);
+    }
+
+    ~Matrix() {
+        if (m) alloc_traits::deallocate(_alloc, m, count());
+    }
+
+    Matrix& operator=(const Matrix& other) {
+        if (this != &other) {
+            Matrix tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    Matrix& operator=(Matrix&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void swap(Matrix& other) noexcept {
+        std::swap(_rows, other._rows);
+        std::swap(_cols, other._cols);
+        std::swap(m, other.m);
+        std::swap(_alloc, other._alloc);
+    }
+
+    template <class E>
+    Matrix& operator=(const matrix_expr<E>& e) {
+        return update(e, T(1), T(0));
+    }
+
+    template <class E>
+    Matrix& operator+=(const matrix_expr<E>& e) {
+        return update(e, T(1), T(1));
+    }
+
+    template <class E>
+    Matrix& operator-=(const matrix_expr<E>& e) {
+        return update(e, T(-1), T(1));
+    }
+
+    // this = alpha * e + beta * this
+    template <class E>
+    Matrix& update(const matrix_expr<E>& e, T alpha, T beta) {
+        const auto& x = as_expr(e.self());
+        if (x.rows() != _rows || x.cols() != _cols) {
+            throw std::runtime_error("Matrix size mismatch in assignment.");
+        }
+        assign_expr(x, alpha, beta, m, _cols);
+        return *this;
+    }
+
+    // Función para llenar la matriz con números aleatorios de tipo double
+    // (Philox en paralelo: la misma semilla da la misma matriz con cualquier número de hilos)
+    void fill_random(T min_value = 1.0, T max_value = 100.0, uint64_t seed = random_seed()) {
+        random_fill(m, count(), min_value, max_value, seed);
+    }
+
+    void fill(T value) {
+        simd_fill(count(), value, m);
+    }
+
+    void fill(const std::vector<T>& v) {
+        if (count() != v.size()) {
+            throw std::runtime_error("Vector and matrix size mismatch. Vector has size " + std::to_string(v.size()) + " and matrix has size " + std::to_string(count()) + ".");
+        }
+        simd_copy(count(), v.data(), m);
+    }
+
+    // Traspone los datos sin memoria auxiliar (salvo un bit por elemento si
+    // no es cuadrada); la matriz pasa a ser cols x rows.
+    void transpose_in_place() {
+        ::transpose_in_place(_rows, _cols, m);
+        std::swap(_rows, _cols);
+    }
+
+    friend leaf_expr<T> as_expr(const Matrix& a) {
+        return leaf_expr<T>(a.m, a._rows, a._cols, a._cols, 1);
+    }
+
+    static void multiply_blocked(const Matrix& a, const Matrix& b, Matrix& c) {
+        if (a._cols != b._rows || c._rows != a._rows || c._cols != b._cols) {
+            throw std::runtime_error("Matrix size mismatch in multiply.");
+        }
+        gemm_blocked<T>(a._rows, b._cols, a._cols, T(1), a.m, a._cols, 1, b.m, b._cols, 1, T(0), c.m, c._cols, 1,
+                        simd_micro_kernel<T>());
+    }
+
+    matrix_view<T> view() { return matrix_view<T>(m, _rows, _cols, _cols); }
+    matrix_view<const T> view() const { return matrix_view<const T>(m, _rows, _cols, _cols); }
+
+    matrix_view<T> block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) {
+        return view().block(row, col, rows, cols);
+    }
+    matrix_view<const T> block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const {
+        return view().block(row, col, rows, cols);
+    }
+
+    matrix_view<T> row_range(std::size_t first, std::size_t last) { return view().row_range(first, last); }
+    matrix_view<const T> row_range(std::size_t first, std::size_t last) const { return view().row_range(first, last); }
+    matrix_view<T> col_range(std::size_t first, std::size_t last) { return view().col_range(first, last); }
+    matrix_view<const T> col_range(std::size_t first, std::size_t last) const { return view().col_range(first, last); }
+
+    // Lado de la matriz (filas si no es cuadrada)
+    unsigned int size() const { return _rows; }
+    std::size_t rows() const { return _rows; }
+    std::size_t cols() const { return _cols; }
+    std::size_t ld() const { return _cols; }
+    std::size_t count() const { return _rows * _cols; }
+    const T* data() const { return m; }
+    T* data() { return m; }
+    allocator_type get_allocator() const { return _alloc; }
+
+    void print() const {
+        for (std::size_t i = 0; i < count(); i++) {
+            std::cout << m[i] << " ";
+            if (i % _cols == _cols - 1) std::cout << std::endl;
+        }
+    }
+};
+
+// C = alpha * A * B + beta * C, evaluado en sitio sobre C
+template <typename T>
+struct non_deduced { using type = T; };
+
+template <typename T, typename Alloc, class EA, class EB>
+void gemm(typename non_deduced<T>::type alpha, const matrix_expr<EA>& a, const matrix_expr<EB>& b,
+          typename non_deduced<T>::type beta, Matrix<T, Alloc>& c) {
+    c.update(a * b, alpha, beta);
+}
+
+// Igual sobre una vista (p.ej. un bloque de C en un producto por bloques)
+template <typename T, class EA, class EB>
+void gemm(typename non_deduced<T>::type alpha, const matrix_expr<EA>& a, const matrix_expr<EB>& b,
+          typename non_deduced<T>::type beta, matrix_view<T> c) {
+    c.update(a * b, alpha, beta);
+}
@@ -0,0 +1,535 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "aligned_allocator.hpp"
+#include "gemm_blocked.hpp"
+#include "numa.hpp"
+#include "random_fill.hpp"
+#include "simd_kernels.hpp"
+#include "thread_pool.hpp"
+#include "tuning_profile.hpp"
+
+// Cómo reparte Matrix1D::operator* el trabajo entre hilos. En modo numa
+// también fill_random se reparte por nodos (ver multiply_numa).
+enum class parallel_mode { async_rows, pool_tiles, numa };
+
+// Bucle que usa Matrix2D::operator*:
+//   ijk           original, c[i][j] += a[i][k] * b[k][j] (B recorrida por columnas)
+//   ikj           recorre B y C por filas; sigue pasando por los punteros a fila
+//   transposed_b  producto escalar de filas de A con filas de B^T
+//   packed_b      B copiada a paneles contiguos de matrix2d_panel columnas
+enum class matrix2d_variant { ijk, ikj, transposed_b, packed_b };
+
+inline matrix2d_variant parse_matrix2d_variant(const std::string& name) {
+    if (name == "ijk") return matrix2d_variant::ijk;
+    if (name == "ikj") return matrix2d_variant::ikj;
+    if (name == "transposed") return matrix2d_variant::transposed_b;
+    if (name == "packed") return matrix2d_variant::packed_b;
+    throw std::runtime_error("Unknown Matrix2D loop variant: " + name + ".");
+}
+
+// Columnas por panel en la variante packed_b
+constexpr unsigned int matrix2d_panel = 8;
+
+template <typename T>
+struct matrix2d_config {
+    static matrix2d_variant variant;
+    static double prepare_seconds;  // trasponer/empaquetar B en el último operator*
+};
+
+// matriz con arreglo bidimensional: se mantiene la vista de punteros a fila
+// (m[i][j]), pero todas las filas viven en un único bloque alineado y cada
+// fila empieza en una línea de caché (stride _ld >= _n).
+template <typename T, typename Alloc = aligned_allocator<T>>
+class Matrix2D : public matrix2d_config<T> {
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    unsigned int _n;
+    std::size_t _ld;
+    T* _data;
+    std::vector<T*> m;
+    Alloc _alloc;
+
+    static std::size_t row_stride(unsigned int n) {
+        std::size_t per_line = std::max<std::size_t>(1, 64 / sizeof(T));
+        return (n + per_line - 1) / per_line * per_line;
+    }
+
+    void allocate() {
+        _data = (_n > 0) ? alloc_traits::allocate(_alloc, _ld * _n) : nullptr;
+        m.resize(_n);
+        for (unsigned int i = 0; i < _n; i++) {
+            m[i] = _data + i * _ld;
+        }
+    }
+
+public:
+    using matrix2d_config<T>::variant;
+    using matrix2d_config<T>::prepare_seconds;
+
+    Matrix2D(unsigned int n, const Alloc& alloc = Alloc()) : _n(n), _ld(row_stride(n)), _alloc(alloc) {
+        allocate();
+    }
+
+    Matrix2D(const Matrix2D& other)
+        : _n(other._n), _ld(other._ld), _alloc(alloc_traits::select_on_container_copy_construction(other._alloc)) {
+        allocate();
+        std::copy(other._data, other._data + _ld * _n, _data);
+    }
+
+    Matrix2D(Matrix2D&& other) noexcept
+        : _n(other._n), _ld(other._ld), _data(other._data), m(std::move(other.m)), _alloc(std::move(other._alloc)) {
+        other._n = 0;
+        other._data = nullptr;
+        other.m.clear();
+    }
+
+    Matrix2D& operator=(Matrix2D other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void swap(Matrix2D& other) noexcept {
+        std::swap(_n, other._n);
+        std::swap(_ld, other._ld);
+        std::swap(_data, other._data);
+        m.swap(other.m);
+        std::swap(_alloc, other._alloc);
+    }
+
+    ~Matrix2D() {
+        if (_data) alloc_traits::deallocate(_alloc, _data, _ld * _n);
+    }
+
+    // Misma secuencia que Matrix/Matrix1D para la misma semilla (se salta el relleno de cada fila)
+    void fill_random(T min_value = 1.0, T max_value = 100.0, uint64_t seed = random_seed()) {
+        random_fill(_data, _n, _n, _ld, min_value, max_value, seed);
+    }
+
+    // El tiempo de trasponer/empaquetar B queda en prepare_seconds, aparte del producto
+    friend Matrix2D operator*(const Matrix2D& a, const Matrix2D& b) {
+        if (a._n != b._n) {
+            throw std::runtime_error("Matrix size mismatch.");
+        }
+
+        Matrix2D c(a._n);
+        prepare_seconds = 0;
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [&start] {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+        switch (variant) {
+            case matrix2d_variant::ikj:
+                multiply_ikj(a, b, c);
+                break;
+            case matrix2d_variant::transposed_b: {
+                Matrix2D bt = b.transposed();
+                prepare_seconds = elapsed();
+                multiply_transposed(a, bt, c);
+                break;
+            }
+            case matrix2d_variant::packed_b: {
+                std::vector<T, Alloc> panels = pack_panels(b);
+                prepare_seconds = elapsed();
+                multiply_packed(a, panels, c);
+                break;
+            }
+            default:
+                multiply_ijk(a, b, c);
+        }
+        return c;
+    }
+
+    static void multiply_ijk(const Matrix2D& a, const Matrix2D& b, Matrix2D& c) {
+        for (unsigned int i = 0; i < a._n; i++) {
+            for (unsigned int j = 0; j < a._n; j++) {
+                c.m[i][j] = 0;
+                for (unsigned int k = 0; k < a._n; k++) {
+                    c.m[i][j] += a.m[i][k] * b.m[k][j];
+                }
+            }
+        }
+    }
+
+    static void multiply_ikj(const Matrix2D& a, const Matrix2D& b, Matrix2D& c) {
+        for (unsigned int i = 0; i < a._n; i++) {
+            for (unsigned int j = 0; j < a._n; j++) c.m[i][j] = 0;
+            for (unsigned int k = 0; k < a._n; k++) {
+                const T aik = a.m[i][k];
+                for (unsigned int j = 0; j < a._n; j++) {
+                    c.m[i][j] += aik * b.m[k][j];
+                }
+            }
+        }
+    }
+
+    Matrix2D transposed() const {
+        Matrix2D t(_n, _alloc);
+        transpose_into(t);
+        return t;
+    }
+
+    // Traspuesta por bloques de 32x32 (lectura y escritura dentro de caché)
+    // sobre una matriz ya reservada del mismo tamaño
+    void transpose_into(Matrix2D& t) const {
+        if (t._n != _n) {
+            throw std::runtime_error("Matrix size mismatch.");
+        }
+        constexpr unsigned int bs = 32;
+        for (unsigned int i0 = 0; i0 < _n; i0 += bs) {
+            for (unsigned int j0 = 0; j0 < _n; j0 += bs) {
+                for (unsigned int i = i0; i < std::min(_n, i0 + bs); i++) {
+                    for (unsigned int j = j0; j < std::min(_n, j0 + bs); j++) {
+                        t.m[j][i] = m[i][j];
+                    }
+                }
+            }
+        }
+    }
+
+    // c[i][j] = fila i de A · fila j de B^T (ambas contiguas)
+    static void multiply_transposed(const Matrix2D& a, const Matrix2D& bt, Matrix2D& c) {
+        for (unsigned int i = 0; i < a._n; i++) {
+            for (unsigned int j = 0; j < a._n; j++) {
+                c.m[i][j] = 0;
+                for (unsigned int k = 0; k < a._n; k++) {
+                    c.m[i][j] += a.m[i][k] * bt.m[j][k];
+                }
+            }
+        }
+    }
+
+    /*
+        B en paneles de matrix2d_panel columnas: el panel p guarda, fila a
+        fila, b[k][p*P .. p*P + P) en posiciones consecutivas (relleno con
+        ceros en el último panel). Un panel completo se recorre de forma
+        secuencial y sin pasar por los punteros a fila.
+    */
+    static std::vector<T, Alloc> pack_panels(const Matrix2D& b) {
+        std::vector<T, Alloc> packed(b._alloc);
+        pack_panels(b, packed);
+        return packed;
+    }
+
+    // Igual, sobre `packed`: si ya tiene capacidad suficiente no se reserva
+    static void pack_panels(const Matrix2D& b, std::vector<T, Alloc>& packed) {
+        constexpr unsigned int P = matrix2d_panel;
+        const unsigned int n = b._n, panels = (n + P - 1) / P;
+        packed.assign(std::size_t(panels) * n * P, T(0));
+        for (unsigned int p = 0; p < panels; p++) {
+            T* dst = packed.data() + std::size_t(p) * n * P;
+            unsigned int width = std::min(P, n - p * P);
+            for (unsigned int k = 0; k < n; k++) {
+                std::copy(b.m[k] + p * P, b.m[k] + p * P + width, dst + std::size_t(k) * P);
+            }
+        }
+    }
+
+    // P acumuladores por fila de A y panel de B; el bucle interno es vectorizable
+    static void multiply_packed(const Matrix2D& a, const std::vector<T, Alloc>& packed, Matrix2D& c) {
+        constexpr unsigned int P = matrix2d_panel;
+        const unsigned int n = a._n, panels = (n + P - 1) / P;
+        for (unsigned int p = 0; p < panels; p++) {
+            const T* panel = packed.data() + std::size_t(p) * n * P;
+            unsigned int width = std::min(P, n - p * P);
+            for (unsigned int i = 0; i < n; i++) {
+                const T* ai = a.m[i];
+                T acc[P] = {};
+                for (unsigned int k = 0; k < n; k++) {
+                    for (unsigned int jj = 0; jj < P; jj++) {
+                        acc[jj] += ai[k] * panel[std::size_t(k) * P + jj];
+                    }
+                }
+                std::copy(acc, acc + width, c.m[i] + p * P);
+            }
+        }
+    }
+
+    void print() const {
+        for (unsigned int i = 0; i < _n; i++) {
+            for (unsigned int j = 0; j < _n; j++) {
+                std::cout << m[i][j] << " ";
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+
+template <typename T>
+matrix2d_variant matrix2d_config<T>::variant = matrix2d_variant::ijk;
+
+template <typename T>
+double matrix2d_config<T>::prepare_seconds = 0;
+
+// Parámetros de paralelismo de Matrix1D, comunes a todos los asignadores
+template <typename T>
+struct matrix1d_config {
+    static parallel_mode mode;
+    static std::size_t threads;     // 0 = hardware_concurrency()
+    static unsigned int tile;       // lado de los tiles de C en modo pool/numa
+    // Fases medidas en modo numa; solo se guardan con numa_record = true (el
+    // programa que las va a mostrar), así los productos medidos no reservan
+    // memoria ni acumulan entradas
+    static bool numa_record;
+    static std::vector<numa_phase_stats> numa_stats;
+};
+
+// Contador global de versiones de contenido de Matrix1D: cada matriz nueva o
+// modificada toma un valor distinto, así una caché puede saber si B cambió
+inline std::uint64_t matrix1d_next_version() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+}
+
+// matriz con arreglo unidimensional
+template <typename T, typename Alloc = aligned_allocator<T>>
+class Matrix1D : public matrix1d_config<T> {
+    using alloc_traits = std::allocator_traits<Alloc>;
+
+    unsigned int _n;
+    T* m;
+    Alloc _alloc;
+    std::uint64_t _version = matrix1d_next_version();   // cambia con el contenido
+
+    std::size_t count() const { return static_cast<std::size_t>(_n) * _n; }
+
+public:
+    using matrix1d_config<T>::mode;
+    using matrix1d_config<T>::threads;
+    using matrix1d_config<T>::tile;
+    using matrix1d_config<T>::numa_record;
+    using matrix1d_config<T>::numa_stats;
+
+    Matrix1D(unsigned int n, const Alloc& alloc = Alloc()) : _n(n), m(nullptr), _alloc(alloc) {
+        if (count()) m = alloc_traits::allocate(_alloc, count());
+    }
+
+    Matrix1D(const Matrix1D& other)
+        : _n(other._n), m(nullptr), _alloc(alloc_traits::select_on_container_copy_construction(other._alloc)) {
+        if (count()) m = alloc_traits::allocate(_alloc, count());
+        std::copy(other.m, other.m + count(), m);
+    }
+
+    Matrix1D(Matrix1D&& other) noexcept
+        : _n(other._n), m(other.m), _alloc(std::move(other._alloc)), _version(other._version) {
+        other._n = 0;
+        other.m = nullptr;
+        other._version = matrix1d_next_version();
+    }
+
+    Matrix1D& operator=(Matrix1D other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void swap(Matrix1D& other) noexcept {
+        std::swap(_n, other._n);
+        std::swap(m, other.m);
+        std::swap(_alloc, other._alloc);
+        std::swap(_version, other._version);
+    }
+
+    ~Matrix1D() {
+        if (m) alloc_traits::deallocate(_alloc, m, count());
+    }
+
+    // En modo numa cada nodo rellena (y así coloca en su memoria) sus filas;
+    // el resultado es el mismo para la misma semilla en cualquier modo.
+    void fill_random(T min_value = 1.0, T max_value = 100.0, uint64_t seed = random_seed()) {
+        _version = matrix1d_next_version();
+        if (mode == parallel_mode::numa) {
+            fill_random_numa(min_value, max_value, seed);
+            return;
+        }
+        random_fill(m, std::size_t(_n) * _n, min_value, max_value, seed);
+    }
+
+    void fill_random_numa(T min_value, T max_value, uint64_t seed) {
+        std::vector<std::unique_ptr<thread_pool>>& pools = numa_pools(threads);
+        const std::size_t n = _n;
+        const T span = max_value - min_value;
+        T* data = m;
+
+        std::vector<double> seconds = numa_parallel(pools, [&](std::size_t k, const numa_submit& submit) {
+            std::pair<std::size_t, std::size_t> rows = numa_rows(n, k, pools);
+            std::size_t chunk = std::max<std::size_t>(1, (rows.second - rows.first + pools[k]->size() - 1) / pools[k]->size());
+            for (std::size_t r0 = rows.first; r0 < rows.second; r0 += chunk) {
+                std::size_t r1 = std::min(rows.second, r0 + chunk);
+                submit([=] { philox::uniform(seed, uint64_t(r0) * n, (r1 - r0) * n, min_value, span, data + r0 * n); });
+            }
+        });
+
+        for (std::size_t k = 0; numa_record && k < pools.size(); k++) {
+            std::pair<std::size_t, std::size_t> rows = numa_rows(n, k, pools);
+            std::size_t r = rows.second - rows.first;
+            numa_stats.push_back({"init", numa_topology()[k].id, pools[k]->size(), r, seconds[k],
+                                  double(r * n * sizeof(T)), 0});
+        }
+    }
+
+    friend Matrix1D operator*(const Matrix1D& a, const Matrix1D& b) {
+        Matrix1D c(a._n);
+        multiply(a, b, c);
+        return c;
+    }
+
+    // c = a * b sobre una matriz ya reservada (p.ej. para dejar la reserva
+    // fuera de una medida), con el reparto de `mode`
+    static void multiply(const Matrix1D& a, const Matrix1D& b, Matrix1D& c) {
+        if (a._n != b._n || c._n != a._n) {
+            throw std::runtime_error("Matrix size mismatch.");
+        }
+
+        // c cambia de contenido: si era la B de una réplica NUMA, deja de valer
+        c._version = matrix1d_next_version();
+        if (mode == parallel_mode::pool_tiles) {
+            multiply_pool(a, b, c);
+        } else if (mode == parallel_mode::numa) {
+            multiply_numa(a, b, c);
+        } else {
+            multiply_async(a, b, c);
+        }
+    }
+
+    // Un std::async por fila de C
+    static void multiply_async(const Matrix1D& a, const Matrix1D& b, Matrix1D& c) {
+        std::vector<std::future<void>> futures;
+
+        for (unsigned int i = 0; i < a._n; i++) {
+            futures.emplace_back(std::async(std::launch::async, [&, i] {
+                for (unsigned int j = 0; j < a._n; j++) {
+                    c.m[i * c._n + j] = 0;
+                    for (unsigned int k = 0; k < a._n; k++) {
+                        c.m[i * c._n + j] += a.m[i * a._n + k] * b.m[k * b._n + j];
+                    }
+                }
+            }));
+        }
+
+        for (auto& f : futures) {
+            f.get(); // Esperar a que todos los hilos terminen
+        }
+    }
+
+    // C se divide en tiles tile x tile; cada tile es una tarea del pool que
+    // calcula su bloque con el GEMM por bloques (k completo).
+    static void multiply_pool(const Matrix1D& a, const Matrix1D& b, Matrix1D& c) {
+        thread_pool& pool = thread_pool::shared(threads);
+        const unsigned int n = a._n;
+        const unsigned int ts = std::max(1u, tile);
+        const micro_kernel<T> kernel = simd_micro_kernel<T>();
+
+        for (unsigned int i0 = 0; i0 < n; i0 += ts) {
+            for (unsigned int j0 = 0; j0 < n; j0 += ts) {
+                pool.submit([&a, &b, &c, &kernel, n, ts, i0, j0] {
+                    std::size_t rows = std::min(ts, n - i0), cols = std::min(ts, n - j0);
+                    gemm_blocked<T>(rows, cols, n, T(1), a.m + (std::size_t)i0 * n, n, 1,
+                                    b.m + j0, n, 1, T(0), c.m + (std::size_t)i0 * n + j0, n, 1, kernel);
+                });
+            }
+        }
+        pool.wait();
+    }
+
+    /*
+        Producto por nodos NUMA: cada nodo calcula las filas de C que
+        corresponden a sus filas de A (las que inicializó fill_random en modo
+        numa), con sus hilos fijados a sus CPUs. Con más de un nodo, B se
+        copia antes en paneles de `tile` filas a una réplica local de cada
+        nodo, así ningún hilo lee memoria remota durante el GEMM. Las réplicas
+        se guardan para la última B (misma dirección y versión): multiplicar
+        otra vez por la misma B no vuelve a copiarla. Con numa_record, los
+        tiempos y el ancho de banda de cada nodo se añaden a numa_stats.
+    */
+    static void multiply_numa(const Matrix1D& a, const Matrix1D& b, Matrix1D& c) {
+        std::vector<std::unique_ptr<thread_pool>>& pools = numa_pools(threads);
+        const std::size_t n = a._n, nodes = pools.size();
+        const std::size_t ts = std::max(1u, tile);
+        const micro_kernel<T> kernel = simd_micro_kernel<T>();
+
+        struct replica_cache {
+            const T* source = nullptr;
+            std::uint64_t version = 0;
+            std::vector<Matrix1D> replicas;
+        };
+        static replica_cache cache;
+
+        std::vector<const T*> local_b(nodes, b.m);
+        if (nodes > 1 && (cache.source != b.m || cache.version != b._version || cache.replicas.size() != nodes ||
+                          cache.replicas[0]._n != b._n)) {
+            cache.replicas.clear();
+            for (std::size_t k = 0; k < nodes; k++) cache.replicas.emplace_back(a._n);
+            std::vector<Matrix1D>& replicas = cache.replicas;
+            std::vector<double> seconds = numa_parallel(pools, [&](std::size_t k, const numa_submit& submit) {
+                T* dst = replicas[k].m;
+                for (std::size_t p0 = 0; p0 < n; p0 += ts) {
+                    std::size_t p1 = std::min(n, p0 + ts);
+                    submit([=, &b] { std::copy(b.m + p0 * n, b.m + p1 * n, dst + p0 * n); });
+                }
+            });
+            cache.source = b.m;
+            cache.version = b._version;
+            for (std::size_t k = 0; numa_record && k < nodes; k++) {
+                numa_stats.push_back({"replicate", numa_topology()[k].id, pools[k]->size(), n, seconds[k],
+                                      2.0 * n * n * sizeof(T), 0});
+            }
+        }
+        if (nodes > 1) {
+            for (std::size_t k = 0; k < nodes; k++) local_b[k] = cache.replicas[k].m;
+        }
+
+        std::vector<double> seconds = numa_parallel(pools, [&](std::size_t k, const numa_submit& submit) {
+            std::pair<std::size_t, std::size_t> rows = numa_rows(n, k, pools);
+            const T* bk = local_b[k];
+            for (std::size_t i0 = rows.first; i0 < rows.second; i0 += ts) {
+                for (std::size_t j0 = 0; j0 < n; j0 += ts) {
+                    submit([&a, &c, &kernel, bk, n, i0, j0, ts, rows] {
+                        std::size_t m = std::min(ts, rows.second - i0), cols = std::min(ts, n - j0);
+                        gemm_blocked<T>(m, cols, n, T(1), a.m + i0 * n, n, 1, bk + j0, n, 1,
+                                        T(0), c.m + i0 * n + j0, n, 1, kernel);
+                    });
+                }
+            }
+        });
+        for (std::size_t k = 0; numa_record && k < nodes; k++) {
+            std::pair<std::size_t, std::size_t> rows = numa_rows(n, k, pools);
+            std::size_t r = rows.second - rows.first;
+            numa_stats.push_back({"multiply", numa_topology()[k].id, pools[k]->size(), r, seconds[k],
+                                  double((2 * r * n + n * n) * sizeof(T)), 2.0 * r * n * n});
+        }
+    }
+
+    void print() const {
+        for (unsigned int i = 0; i < _n * _n; i++) {
+            std::cout << m[i] << " ";
+            if (i % _n == _n - 1) std::cout << std::endl;
+        }
+    }
+};
+
+template <typename T>
+parallel_mode matrix1d_config<T>::mode = parallel_mode::async_rows;
+
+// Hilos y tile: los del perfil de ajuste de la máquina si lo hay
+template <typename T>
+std::size_t matrix1d_config<T>::threads = tuning_get_size<T>("threads", 0);
+
+template <typename T>
+unsigned int matrix1d_config<T>::tile = tuning_get_size<T>("tile", 256);
+
+template <typename T>
+bool matrix1d_config<T>::numa_record = false;
+
+template <typename T>
+std::vector<numa_phase_stats> matrix1d_config<T>::numa_stats;
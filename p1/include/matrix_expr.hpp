@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "cache_oblivious.hpp"
+#include "simd_kernels.hpp"
+
+/*
+    Expression templates para Matrix<T>.
+
+    A + B, A - B, s * A, -A, transpose(A) y A * B no calculan nada: devuelven
+    un nodo ligero que guarda punteros y strides a sus operandos. El trabajo
+    se hace al asignar a una Matrix, evaluando directamente sobre el destino:
+
+        dst = alpha * expr + beta * dst
+
+    - Los subárboles elemento a elemento (sumas, escalados, traspuestas de
+      hojas) se evalúan en un único recorrido fusionado.
+    - Los productos escriben con el GEMM sobre el destino (beta = 1 para los
+      términos siguientes), así que A*B + C*D no crea temporales N x N.
+    - Escalados y traspuestas de hojas se pliegan en alpha y en los strides
+      del GEMM; solo se materializa un operando de un producto si es una
+      expresión compuesta, p.ej. (A + B) * C.
+
+    Si el destino aparece en la expresión de forma que se leería después de
+    haber sido escrito (C = C * A, C = transpose(C), C = A*B + C, ...) se
+    evalúa primero en un temporal.
+*/
+
+template <typename T>
+struct matrix_gemm;
+
+template <class E>
+struct matrix_expr {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+// Operando de un GEMM: puntero + strides + factor de escala. Si la expresión
+// tuvo que materializarse, `storage` es el dueño de los datos.
+template <typename T>
+struct gemm_operand {
+    const T* p;
+    std::ptrdiff_t rs;
+    std::ptrdiff_t cs;
+    T scale;
+    std::vector<T> storage;
+};
+
+// Estado de aliasing de una expresión respecto al destino
+enum class alias_state { none = 0, same_position = 1, unsafe = 2 };
+
+inline alias_state alias_max(alias_state a, alias_state b) {
+    return static_cast<int>(a) > static_cast<int>(b) ? a : b;
+}
+
+template <class E, typename T>
+gemm_operand<T> materialize(const E& e) {
+    gemm_operand<T> op{nullptr, std::ptrdiff_t(e.cols()), 1, T(1), std::vector<T>(e.rows() * e.cols())};
+    e.eval_into(T(1), T(0), op.storage.data(), e.cols());
+    op.p = op.storage.data();
+    return op;
+}
+
+// Hoja: vista (no propietaria) sobre los datos de una matriz
+template <typename T>
+struct leaf_expr : matrix_expr<leaf_expr<T>> {
+    using value_type = T;
+    static constexpr bool elementwise = true;
+
+    const T* p;
+    std::size_t _rows, _cols;
+    std::ptrdiff_t rs, cs;
+
+    leaf_expr(const T* p, std::size_t rows, std::size_t cols, std::ptrdiff_t rs, std::ptrdiff_t cs)
+        : p(p), _rows(rows), _cols(cols), rs(rs), cs(cs) {}
+
+    std::size_t rows() const { return _rows; }
+    std::size_t cols() const { return _cols; }
+    T coeff(std::size_t i, std::size_t j) const { return p[i * rs + j * cs]; }
+
+    bool contiguous() const { return cs == 1 && rs == std::ptrdiff_t(_cols); }
+
+    alias_state aliasing(const T* begin, const T* end, std::ptrdiff_t ld) const {
+        if (_rows == 0 || _cols == 0) return alias_state::none;
+        const T* last = p + (_rows - 1) * rs + (_cols - 1) * cs;
+        if (last < begin || p >= end) return alias_state::none;
+        return (p == begin && rs == ld && cs == 1) ? alias_state::same_position : alias_state::unsafe;
+    }
+
+    void eval_into(T alpha, T beta, T* dst, std::ptrdiff_t ld) const {
+        if (rs == 1 && cs != 1 && alpha == T(1) && beta == T(0)) {
+            // traspuesta de filas contiguas: copia recursiva por bloques
+            transpose_recursive(_cols, _rows, p, cs, dst, ld);
+            return;
+        }
+        for (std::size_t i = 0; i < _rows; i++) {
+            const T* src = p + i * rs;
+            T* d = dst + i * ld;
+            if (beta == T(0)) {
+                for (std::size_t j = 0; j < _cols; j++) d[j] = alpha * src[j * cs];
+            } else {
+                for (std::size_t j = 0; j < _cols; j++) d[j] = alpha * src[j * cs] + beta * d[j];
+            }
+        }
+    }
+
+    gemm_operand<T> operand() const { return {p, rs, cs, T(1), {}}; }
+};
+
+// Cualquier expresión se guarda por valor; Matrix<T> se convierte en hoja
+// mediante su as_expr (amigo, encontrado por ADL).
+template <class E>
+const E& as_expr(const matrix_expr<E>& e) {
+    return e.self();
+}
+
+template <class E>
+using stored_expr = typename std::decay<decltype(as_expr(std::declval<const E&>()))>::type;
+
+template <class E>
+struct scaled_expr : matrix_expr<scaled_expr<E>> {
+    using value_type = typename E::value_type;
+    using T = value_type;
+    static constexpr bool elementwise = E::elementwise;
+
+    E e;
+    T s;
+
+    scaled_expr(const E& e, T s) : e(e), s(s) {}
+
+    std::size_t rows() const { return e.rows(); }
+    std::size_t cols() const { return e.cols(); }
+    T coeff(std::size_t i, std::size_t j) const { return s * e.coeff(i, j); }
+    alias_state aliasing(const T* b, const T* en, std::ptrdiff_t ld) const { return e.aliasing(b, en, ld); }
+    void eval_into(T alpha, T beta, T* dst, std::ptrdiff_t ld) const { e.eval_into(alpha * s, beta, dst, ld); }
+
+    gemm_operand<T> operand() const {
+        gemm_operand<T> op = e.operand();
+        op.scale *= s;
+        return op;
+    }
+};
+
+template <class E>
+struct transpose_expr : matrix_expr<transpose_expr<E>> {
+    using value_type = typename E::value_type;
+    using T = value_type;
+    static constexpr bool elementwise = E::elementwise;
+
+    E e;
+
+    explicit transpose_expr(const E& e) : e(e) {}
+
+    std::size_t rows() const { return e.cols(); }
+    std::size_t cols() const { return e.rows(); }
+    T coeff(std::size_t i, std::size_t j) const { return e.coeff(j, i); }
+
+    alias_state aliasing(const T* b, const T* en, std::ptrdiff_t ld) const {
+        // los índices se cruzan: cualquier solape es peligroso
+        return e.aliasing(b, en, ld) == alias_state::none ? alias_state::none : alias_state::unsafe;
+    }
+
+    void eval_into(T alpha, T beta, T* dst, std::ptrdiff_t ld) const {
+        gemm_operand<T> op = operand();
+        leaf_expr<T>(op.p, rows(), cols(), op.rs, op.cs).eval_into(alpha * op.scale, beta, dst, ld);
+    }
+
+    gemm_operand<T> operand() const {
+        gemm_operand<T> op = materialize<E, T>(e);
+        std::swap(op.rs, op.cs);
+        return op;
+    }
+};
+
+template <class L, class R>
+struct sum_expr : matrix_expr<sum_expr<L, R>> {
+    using value_type = typename L::value_type;
+    using T = value_type;
+    static constexpr bool elementwise = L::elementwise && R::elementwise;
+
+    L l;
+    R r;
+    T sign;  // +1 suma, -1 resta
+
+    sum_expr(const L& l, const R& r, T sign) : l(l), r(r), sign(sign) {
+        if (l.rows() != r.rows() || l.cols() != r.cols()) {
+            throw std::runtime_error("Matrix size mismatch. Both operands of + and - must have the same size.");
+        }
+    }
+
+    std::size_t rows() const { return l.rows(); }
+    std::size_t cols() const { return l.cols(); }
+
+    T coeff(std::size_t i, std::size_t j) const {
+        if constexpr (elementwise) {
+            return l.coeff(i, j) + sign * r.coeff(i, j);
+        } else {
+            throw std::logic_error("coeff() on a non element-wise expression.");
+        }
+    }
+
+    alias_state aliasing(const T* b, const T* en, std::ptrdiff_t ld) const {
+        alias_state la = l.aliasing(b, en, ld), ra = r.aliasing(b, en, ld);
+        // evaluado en dos pasadas: solo uno de los dos lados puede leer el destino
+        if (!elementwise && la != alias_state::none && ra != alias_state::none) return alias_state::unsafe;
+        return alias_max(la, ra);
+    }
+
+    void eval_into(T alpha, T beta, T* dst, std::ptrdiff_t ld) const {
+        if constexpr (elementwise) {
+            eval_fused(alpha, beta, dst, ld);
+        } else {
+            // El lado que lee el destino se evalúa primero, antes de sobrescribirlo.
+            if (r.aliasing(dst, dst + (rows() - 1) * ld + cols(), ld) != alias_state::none) {
+                r.eval_into(alpha * sign, beta, dst, ld);
+                l.eval_into(alpha, T(1), dst, ld);
+            } else {
+                l.eval_into(alpha, beta, dst, ld);
+                r.eval_into(alpha * sign, T(1), dst, ld);
+            }
+        }
+    }
+
+    gemm_operand<T> operand() const { return materialize<sum_expr, T>(*this); }
+
+private:
+    void eval_fused(T alpha, T beta, T* dst, std::ptrdiff_t ld) const {
+        if constexpr (std::is_same<L, leaf_expr<T>>::value && std::is_same<R, leaf_expr<T>>::value) {
+            // A + B sobre datos contiguos: kernel SIMD
+            if (alpha == T(1) && beta == T(0) && sign == T(1) && l.contiguous() && r.contiguous() &&
+                ld == std::ptrdiff_t(cols())) {
+                simd_add(rows() * cols(), l.p, r.p, dst);
+                return;
+            }
+        }
+        for (std::size_t i = 0; i < rows(); i++) {
+            T* d = dst + i * ld;
+            if (beta == T(0)) {
+                for (std::size_t j = 0; j < cols(); j++) d[j] = alpha * coeff(i, j);
+            } else {
+                for (std::size_t j = 0; j < cols(); j++) d[j] = alpha * coeff(i, j) + beta * d[j];
+            }
+        }
+    }
+};
+
+template <class L, class R>
+struct product_expr : matrix_expr<product_expr<L, R>> {
+    using value_type = typename L::value_type;
+    using T = value_type;
+    static constexpr bool elementwise = false;
+
+    L l;
+    R r;
+
+    product_expr(const L& l, const R& r) : l(l), r(r) {
+        if (l.cols() != r.rows()) {
+            throw std::runtime_error("Matrix size mismatch. Inner dimensions of the product must agree.");
+        }
+    }
+
+    std::size_t rows() const { return l.rows(); }
+    std::size_t cols() const { return r.cols(); }
+    T coeff(std::size_t, std::size_t) const { throw std::logic_error("coeff() on a product expression."); }
+
+    alias_state aliasing(const T* b, const T* en, std::ptrdiff_t ld) const {
+        // el GEMM lee los operandos mientras escribe: cualquier solape es peligroso
+        alias_state a = alias_max(l.aliasing(b, en, ld), r.aliasing(b, en, ld));
+        return a == alias_state::none ? alias_state::none : alias_state::unsafe;
+    }
+
+    void eval_into(T alpha, T beta, T* dst, std::ptrdiff_t ld) const {
+        gemm_operand<T> a = l.operand();
+        gemm_operand<T> b = r.operand();
+        matrix_gemm<T>::gemm_raw(rows(), cols(), l.cols(), alpha * a.scale * b.scale,
+                            a.p, a.rs, a.cs, b.p, b.rs, b.cs, beta, dst, ld, 1);
+    }
+
+    gemm_operand<T> operand() const { return materialize<product_expr, T>(*this); }
+};
+
+// dst = alpha * e + beta * dst, pasando por un temporal si hay aliasing peligroso
+template <class E, typename T>
+void assign_expr(const E& e, T alpha, T beta, T* dst, std::ptrdiff_t ld) {
+    if (e.rows() == 0 || e.cols() == 0) return;
+    const T* end = dst + (e.rows() - 1) * ld + e.cols();
+    if (e.aliasing(dst, end, ld) == alias_state::unsafe) {
+        gemm_operand<T> tmp = materialize<E, T>(e);
+        leaf_expr<T>(tmp.p, e.rows(), e.cols(), tmp.rs, tmp.cs).eval_into(alpha, beta, dst, ld);
+    } else {
+        e.eval_into(alpha, beta, dst, ld);
+    }
+}
+
+// ----------------------------------------------------------------- operadores
+
+template <class L, class R>
+sum_expr<stored_expr<L>, stored_expr<R>> operator+(const matrix_expr<L>& l, const matrix_expr<R>& r) {
+    using V = typename stored_expr<L>::value_type;
+    return {as_expr(l.self()), as_expr(r.self()), V(1)};
+}
+
+template <class L, class R>
+sum_expr<stored_expr<L>, stored_expr<R>> operator-(const matrix_expr<L>& l, const matrix_expr<R>& r) {
+    using V = typename stored_expr<L>::value_type;
+    return {as_expr(l.self()), as_expr(r.self()), V(-1)};
+}
+
+template <class L, class R>
+product_expr<stored_expr<L>, stored_expr<R>> operator*(const matrix_expr<L>& l, const matrix_expr<R>& r) {
+    return {as_expr(l.self()), as_expr(r.self())};
+}
+
+template <class E>
+scaled_expr<stored_expr<E>> operator*(typename stored_expr<E>::value_type s, const matrix_expr<E>& e) {
+    return {as_expr(e.self()), s};
+}
+
+template <class E>
+scaled_expr<stored_expr<E>> operator*(const matrix_expr<E>& e, typename stored_expr<E>::value_type s) {
+    return {as_expr(e.self()), s};
+}
+
+template <class E>
+scaled_expr<stored_expr<E>> operator-(const matrix_expr<E>& e) {
+    using V = typename stored_expr<E>::value_type;
+    return {as_expr(e.self()), V(-1)};
+}
+
+// La traspuesta de una hoja es otra hoja con los strides cruzados (sin copia).
+template <typename T>
+leaf_expr<T> transpose_leaf(const leaf_expr<T>& e) {
+    return leaf_expr<T>(e.p, e.cols(), e.rows(), e.cs, e.rs);
+}
+
+template <class E>
+transpose_expr<E> transpose_leaf(const E& e) {
+    return transpose_expr<E>(e);
+}
+
+template <class E>
+auto transpose(const matrix_expr<E>& e) {
+    return transpose_leaf(as_expr(e.self()));
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "gemm_blocked.hpp"
+#include "matrix.hpp"
+#include "simd_kernels.hpp"
+
+/*
+    Formato binario de matriz en disco, pensado para abrirse con mmap:
+
+        [cabecera 4096 B][tile (0,0)][tile (0,1)] ... [tile (R-1,C-1)]
+
+    Los tiles se guardan por filas de tiles; cada uno es un bloque denso
+    tile_rows x tile_cols en row-major (los de los bordes se rellenan con
+    ceros hasta el tamaño completo), de modo que un tile es contiguo en el
+    fichero y se puede pasar tal cual al GEMM con ld = tile_cols.
+*/
+
+enum class matrix_dtype : std::uint32_t { float32 = 1, float64 = 2 };
+
+template <typename T> struct dtype_of;
+template <> struct dtype_of<float> { static constexpr matrix_dtype value = matrix_dtype::float32; };
+template <> struct dtype_of<double> { static constexpr matrix_dtype value = matrix_dtype::float64; };
+
+struct matrix_file_header {
+    char magic[8];               // "PACSMAT"
+    std::uint32_t version;
+    matrix_dtype dtype;
+    std::uint64_t rows, cols;
+    std::uint64_t tile_rows, tile_cols;
+    std::uint64_t data_offset;   // múltiplo del tamaño de página
+};
+
+static constexpr char matrix_file_magic[8] = "PACSMAT";
+static constexpr std::uint32_t matrix_file_version = 1;
+static constexpr std::uint64_t matrix_file_data_offset = 4096;
+
+// Matriz respaldada por un fichero mapeado en memoria
+template <typename T>
+class mapped_matrix {
+    int _fd = -1;
+    void* _map = nullptr;
+    std::size_t _map_size = 0;
+    bool _writable = false;
+    matrix_file_header _h{};
+
+    static std::runtime_error sys_error(const std::string& what, const std::string& path) {
+        return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+    }
+
+    void map(const std::string& path) {
+        int prot = PROT_READ | (_writable ? PROT_WRITE : 0);
+        _map = mmap(nullptr, _map_size, prot, MAP_SHARED, _fd, 0);
+        if (_map == MAP_FAILED) {
+            _map = nullptr;
+            throw sys_error("Cannot mmap", path);
+        }
+    }
+
+    // Tamaño del mapeo según la cabecera; rechaza tiles vacíos y tamaños que
+    // no caben en size_t (una cabecera corrupta no debe dividir por cero)
+    void set_map_size(const std::string& path) {
+        if (_h.tile_rows == 0 || _h.tile_cols == 0) {
+            throw std::runtime_error("Tile dimensions must be positive.");
+        }
+        const std::uint64_t max = std::numeric_limits<std::size_t>::max();
+        auto fits = [max](std::uint64_t a, std::uint64_t b) { return b == 0 || a <= max / b; };
+        std::uint64_t tiles = tile_count_rows(), tile_elems = _h.tile_rows;
+        bool ok = fits(tiles, tile_count_cols()) && fits(tile_elems, _h.tile_cols);
+        if (ok) {
+            tiles *= tile_count_cols();
+            tile_elems *= _h.tile_cols;
+            ok = fits(tile_elems, sizeof(T)) && fits(tiles, tile_elems * sizeof(T)) &&
+                 tiles * tile_elems * sizeof(T) <= max - _h.data_offset;
+        }
+        if (!ok) {
+            throw std::runtime_error("Matrix file '" + path + "' is too large to map.");
+        }
+        _map_size = _h.data_offset + tiles * tile_elems * sizeof(T);
+    }
+
+    mapped_matrix() = default;
+
+public:
+    mapped_matrix(const mapped_matrix&) = delete;
+    mapped_matrix& operator=(const mapped_matrix&) = delete;
+
+    mapped_matrix(mapped_matrix&& o) noexcept
+        : _fd(o._fd), _map(o._map), _map_size(o._map_size), _writable(o._writable), _h(o._h) {
+        o._fd = -1;
+        o._map = nullptr;
+    }
+
+    ~mapped_matrix() {
+        if (_map) {
+            if (_writable) msync(_map, _map_size, MS_SYNC);
+            munmap(_map, _map_size);
+        }
+        if (_fd >= 0) close(_fd);
+    }
+
+    // Crea (o trunca) un fichero para una matriz rows x cols con tiles del tamaño indicado
+    static mapped_matrix create(const std::string& path, std::uint64_t rows, std::uint64_t cols,
+                                std::uint64_t tile_rows, std::uint64_t tile_cols) {
+        mapped_matrix mm;
+        std::memcpy(mm._h.magic, matrix_file_magic, sizeof(matrix_file_magic));
+        mm._h.version = matrix_file_version;
+        mm._h.dtype = dtype_of<T>::value;
+        mm._h.rows = rows;
+        mm._h.cols = cols;
+        mm._h.tile_rows = tile_rows;
+        mm._h.tile_cols = tile_cols;
+        mm._h.data_offset = matrix_file_data_offset;
+        mm.set_map_size(path);
+
+        mm._writable = true;
+        mm._fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (mm._fd < 0) throw sys_error("Cannot create", path);
+        if (ftruncate(mm._fd, mm._map_size) != 0) throw sys_error("Cannot resize", path);
+        mm.map(path);
+        std::memcpy(mm._map, &mm._h, sizeof(mm._h));
+        return mm;
+    }
+
+    static mapped_matrix open(const std::string& path, bool writable = false) {
+        mapped_matrix mm;
+        mm._writable = writable;
+        mm._fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (mm._fd < 0) throw sys_error("Cannot open", path);
+
+        if (pread(mm._fd, &mm._h, sizeof(mm._h), 0) != static_cast<ssize_t>(sizeof(mm._h)) ||
+            std::memcmp(mm._h.magic, matrix_file_magic, sizeof(matrix_file_magic)) != 0) {
+            throw std::runtime_error("'" + path + "' is not a matrix file.");
+        }
+        if (mm._h.version != matrix_file_version) {
+            throw std::runtime_error("Unsupported matrix file version " + std::to_string(mm._h.version) + ".");
+        }
+        if (mm._h.dtype != dtype_of<T>::value) {
+            throw std::runtime_error("Matrix file '" + path + "' holds a different element type.");
+        }
+
+        mm.set_map_size(path);
+        struct stat st;
+        fstat(mm._fd, &st);
+        if (static_cast<std::uint64_t>(st.st_size) < mm._map_size) {
+            throw std::runtime_error("Matrix file '" + path + "' is truncated.");
+        }
+        mm.map(path);
+        return mm;
+    }
+
+    std::uint64_t rows() const { return _h.rows; }
+    std::uint64_t cols() const { return _h.cols; }
+    std::uint64_t tile_rows() const { return _h.tile_rows; }
+    std::uint64_t tile_cols() const { return _h.tile_cols; }
+    std::uint64_t tile_count_rows() const { return _h.rows / _h.tile_rows + (_h.rows % _h.tile_rows != 0); }
+    std::uint64_t tile_count_cols() const { return _h.cols / _h.tile_cols + (_h.cols % _h.tile_cols != 0); }
+    std::size_t tile_bytes() const { return _h.tile_rows * _h.tile_cols * sizeof(T); }
+
+    // Filas / columnas válidas del tile (los de los bordes son más pequeños)
+    std::size_t tile_height(std::uint64_t ti) const { return std::min(_h.tile_rows, _h.rows - ti * _h.tile_rows); }
+    std::size_t tile_width(std::uint64_t tj) const { return std::min(_h.tile_cols, _h.cols - tj * _h.tile_cols); }
+
+    T* tile(std::uint64_t ti, std::uint64_t tj) const {
+        char* base = static_cast<char*>(_map) + _h.data_offset;
+        return reinterpret_cast<T*>(base + (ti * tile_count_cols() + tj) * tile_bytes());
+    }
+
+    // Lectura anticipada: el kernel empieza a traer el tile mientras se calcula el anterior
+    void prefetch_tile(std::uint64_t ti, std::uint64_t tj) const {
+        if (ti < tile_count_rows() && tj < tile_count_cols()) {
+            madvise(tile(ti, tj), tile_bytes(), MADV_WILLNEED);
+        }
+    }
+
+    // Saca el tile del espacio residente del proceso (si estaba escrito, se vuelca antes)
+    void release_tile(std::uint64_t ti, std::uint64_t tj) const {
+        if (_writable) msync(tile(ti, tj), tile_bytes(), MS_ASYNC);
+        madvise(tile(ti, tj), tile_bytes(), MADV_DONTNEED);
+    }
+
+    // Copia a/desde una Matrix<T> en memoria (solo para matrices que caben en RAM)
+    template <typename Alloc>
+    void store(const Matrix<T, Alloc>& m) {
+        if (m.rows() != rows() || m.cols() != cols()) throw std::runtime_error("Matrix size mismatch.");
+        for (std::uint64_t ti = 0; ti < tile_count_rows(); ti++) {
+            for (std::uint64_t tj = 0; tj < tile_count_cols(); tj++) {
+                T* t = tile(ti, tj);
+                std::fill(t, t + _h.tile_rows * _h.tile_cols, T(0));
+                for (std::size_t i = 0; i < tile_height(ti); i++) {
+                    const T* src = m.data() + (ti * _h.tile_rows + i) * m.cols() + tj * _h.tile_cols;
+                    std::copy(src, src + tile_width(tj), t + i * _h.tile_cols);
+                }
+            }
+        }
+    }
+
+    Matrix<T> load() const {
+        Matrix<T> m(static_cast<std::size_t>(rows()), static_cast<std::size_t>(cols()));
+        for (std::uint64_t ti = 0; ti < tile_count_rows(); ti++) {
+            for (std::uint64_t tj = 0; tj < tile_count_cols(); tj++) {
+                const T* t = tile(ti, tj);
+                for (std::size_t i = 0; i < tile_height(ti); i++) {
+                    std::copy(t + i * _h.tile_cols, t + i * _h.tile_cols + tile_width(tj),
+                              m.data() + (ti * _h.tile_rows + i) * cols() + tj * _h.tile_cols);
+                }
+            }
+        }
+        return m;
+    }
+};
+
+// Conjunto residente mínimo de out_of_core_multiply con los tiles de A y B:
+// un tile de C (tile_rows de A x tile_cols de B) y dos de A y de B
+template <typename T>
+std::size_t out_of_core_min_budget(const mapped_matrix<T>& a, const mapped_matrix<T>& b) {
+    return a.tile_rows() * b.tile_cols() * sizeof(T) + 2 * a.tile_bytes() + 2 * b.tile_bytes();
+}
+
+/*
+    C = A * B con las tres matrices en disco. El conjunto residente se limita
+    a `memory_budget` bytes:
+
+        - mínimo: tile de C + tile de A + tile de B + lectura anticipada de los
+          siguientes tiles de A y B (5 tiles);
+        - si el presupuesto da para toda una fila de tiles de A, esa fila se
+          mantiene residente mientras se recorren todas las columnas de C.
+
+    Cada tile de C se calcula sobre el propio mapeo (beta = 0 en el primer
+    tile de k, 1 en el resto) y se libera al terminarlo.
+*/
+template <typename T>
+void out_of_core_multiply(const mapped_matrix<T>& a, const mapped_matrix<T>& b, mapped_matrix<T>& c,
+                          std::size_t memory_budget) {
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::runtime_error("Matrix size mismatch in out-of-core multiply.");
+    }
+    if (a.tile_cols() != b.tile_rows() || c.tile_rows() != a.tile_rows() || c.tile_cols() != b.tile_cols()) {
+        throw std::runtime_error("Tile layouts of A, B and C are not compatible.");
+    }
+
+    const std::size_t min_set = out_of_core_min_budget(a, b);
+    if (memory_budget < min_set) {
+        throw std::runtime_error("Memory budget of " + std::to_string(memory_budget) + " bytes is below the " +
+                                 std::to_string(min_set) + " bytes needed for one tile of C, A and B plus read-ahead.");
+    }
+    const std::uint64_t tk_count = a.tile_count_cols();
+    const bool keep_a_row = c.tile_bytes() + tk_count * a.tile_bytes() + 2 * b.tile_bytes() <= memory_budget;
+
+    const micro_kernel<T> kernel = simd_micro_kernel<T>();
+    const std::ptrdiff_t lda = a.tile_cols(), ldb = b.tile_cols(), ldc = c.tile_cols();
+
+    for (std::uint64_t ti = 0; ti < c.tile_count_rows(); ti++) {
+        for (std::uint64_t tj = 0; tj < c.tile_count_cols(); tj++) {
+            T* ct = c.tile(ti, tj);
+            for (std::uint64_t tk = 0; tk < tk_count; tk++) {
+                // siguiente pareja de tiles que se va a necesitar
+                if (tk + 1 < tk_count) {
+                    if (!keep_a_row || tj == 0) a.prefetch_tile(ti, tk + 1);
+                    b.prefetch_tile(tk + 1, tj);
+                } else {
+                    a.prefetch_tile(tj + 1 < c.tile_count_cols() ? ti : ti + 1, 0);
+                    b.prefetch_tile(0, tj + 1 < c.tile_count_cols() ? tj + 1 : 0);
+                }
+
+                gemm_blocked<T>(c.tile_height(ti), c.tile_width(tj), a.tile_width(tk), T(1),
+                                a.tile(ti, tk), lda, 1, b.tile(tk, tj), ldb, 1,
+                                tk == 0 ? T(0) : T(1), ct, ldc, 1, kernel);
+
+                b.release_tile(tk, tj);
+                if (!keep_a_row) a.release_tile(ti, tk);
+            }
+            c.release_tile(ti, tj);
+        }
+        if (keep_a_row) {
+            for (std::uint64_t tk = 0; tk < tk_count; tk++) a.release_tile(ti, tk);
+        }
+    }
+}
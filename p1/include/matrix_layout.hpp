@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "cache_oblivious.hpp"
+#include "matrix.hpp"
+
+/*
+    Matrices densas con el orden de almacenamiento como parámetro de
+    plantilla (política de layout):
+
+        row_major    a[i * cols + j] (el de Matrix<T>)
+        col_major    a[j * rows + i]
+        tiled<B>     bloques B x B contiguos (row-major dentro del bloque),
+                     bloques en orden row-major
+        morton<B>    los mismos bloques B x B en orden Z (Morton): bloques
+                     vecinos en 2D quedan cerca en memoria
+
+    Con tiled y morton los bloques del borde se rellenan con ceros, así que
+    los productos trabajan siempre sobre bloques completos. El orden Z es
+    por bloques y no por elementos: dentro del bloque el micro-kernel SIMD
+    necesita filas contiguas.
+
+    LayoutMatrix<T, Layout> accede por (i, j) con cualquier layout y cada
+    layout tiene su propio producto (layout_multiply). Matrix<T> sigue
+    siendo row-major: sus expresiones y vistas se basan en strides. Se pasa
+    de una a otra con from_dense / to_dense.
+*/
+
+// Cada política sabe cuántos elementos ocupa una matriz rows x cols y en
+// qué posición va el elemento (i, j).
+struct row_major {
+    static constexpr const char* name = "row";
+    std::size_t rows = 0, cols = 0;
+
+    row_major() = default;
+    row_major(std::size_t rows, std::size_t cols) : rows(rows), cols(cols) {}
+
+    std::size_t size() const { return rows * cols; }
+    std::size_t offset(std::size_t i, std::size_t j) const { return i * cols + j; }
+};
+
+struct col_major {
+    static constexpr const char* name = "col";
+    std::size_t rows = 0, cols = 0;
+
+    col_major() = default;
+    col_major(std::size_t rows, std::size_t cols) : rows(rows), cols(cols) {}
+
+    std::size_t size() const { return rows * cols; }
+    std::size_t offset(std::size_t i, std::size_t j) const { return j * rows + i; }
+};
+
+// Bloques de 64 x 64: 32 KB en double, 8 páginas de 4 KB por bloque
+template <std::size_t B = 64>
+struct tiled {
+    static constexpr const char* name = "tiled";
+    static constexpr std::size_t tile = B;
+    std::size_t rows = 0, cols = 0;
+    std::size_t tile_rows = 0, tile_cols = 0;
+    // Posición (en elementos) de cada bloque, indexado por ti * tile_cols + tj
+    std::vector<std::size_t> tile_start;
+
+    tiled() = default;
+    tiled(std::size_t rows, std::size_t cols)
+        : rows(rows), cols(cols), tile_rows((rows + B - 1) / B), tile_cols((cols + B - 1) / B),
+          tile_start(tile_rows * tile_cols) {
+        for (std::size_t t = 0; t < tile_start.size(); t++) tile_start[t] = t * B * B;
+    }
+
+    std::size_t size() const { return tile_rows * tile_cols * B * B; }
+    std::size_t tile_offset(std::size_t ti, std::size_t tj) const { return tile_start[ti * tile_cols + tj]; }
+    std::size_t offset(std::size_t i, std::size_t j) const {
+        return tile_offset(i / B, j / B) + (i % B) * B + j % B;
+    }
+};
+
+// Intercala los bits de i (posiciones pares) y j (impares)
+inline std::uint64_t morton_code(std::uint32_t i, std::uint32_t j) {
+    auto spread = [](std::uint64_t x) {
+        x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+        x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+        x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+        x = (x | (x << 2)) & 0x3333333333333333ull;
+        x = (x | (x << 1)) & 0x5555555555555555ull;
+        return x;
+    };
+    return spread(i) | (spread(j) << 1);
+}
+
+// Los bloques se ordenan por su código Morton y se guardan seguidos (sin
+// huecos aunque la rejilla de bloques no sea cuadrada ni potencia de 2)
+template <std::size_t B = 64>
+struct morton : tiled<B> {
+    static constexpr const char* name = "morton";
+
+    morton() = default;
+    morton(std::size_t rows, std::size_t cols) : tiled<B>(rows, cols) {
+        const std::size_t tiles = this->tile_start.size();
+        std::vector<std::size_t> order(tiles);
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+            return morton_code(std::uint32_t(x / this->tile_cols), std::uint32_t(x % this->tile_cols)) <
+                   morton_code(std::uint32_t(y / this->tile_cols), std::uint32_t(y % this->tile_cols));
+        });
+        for (std::size_t rank = 0; rank < tiles; rank++) this->tile_start[order[rank]] = rank * B * B;
+    }
+};
+
+template <typename T, typename Layout, typename Alloc = aligned_allocator<T>>
+class LayoutMatrix {
+    Layout _layout;
+    std::vector<T, Alloc> _data;
+
+public:
+    using value_type = T;
+    using layout_type = Layout;
+
+    LayoutMatrix() = default;
+    explicit LayoutMatrix(unsigned int n) : LayoutMatrix(n, n) {}
+    // Inicializada a cero (también el relleno de los bloques del borde)
+    LayoutMatrix(std::size_t rows, std::size_t cols) : _layout(rows, cols), _data(_layout.size(), T(0)) {}
+
+    T& operator()(std::size_t i, std::size_t j) { return _data[_layout.offset(i, j)]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return _data[_layout.offset(i, j)]; }
+
+    template <typename A>
+    static LayoutMatrix from_dense(const Matrix<T, A>& a) {
+        LayoutMatrix r(a.rows(), a.cols());
+        r.load(a.data(), a.ld(), r._layout);
+        return r;
+    }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> a(rows(), cols());
+        store(a.data(), a.ld(), _layout);
+        return a;
+    }
+
+    std::size_t rows() const { return _layout.rows; }
+    std::size_t cols() const { return _layout.cols; }
+    // Elementos guardados, relleno incluido
+    std::size_t storage_size() const { return _data.size(); }
+    const Layout& layout() const { return _layout; }
+    const T* data() const { return _data.data(); }
+    T* data() { return _data.data(); }
+
+    friend LayoutMatrix operator*(const LayoutMatrix& a, const LayoutMatrix& b) {
+        LayoutMatrix c(a.rows(), b.cols());
+        layout_multiply(a, b, c);
+        return c;
+    }
+
+private:
+    // Copia desde / hacia un arreglo row-major con distancia ld. Cada layout
+    // recorre su memoria en orden: por filas, con la traspuesta recursiva o
+    // por segmentos de fila de cada bloque.
+    void load(const T* src, std::size_t ld, const row_major&) {
+        for (std::size_t i = 0; i < rows(); i++) std::copy(src + i * ld, src + i * ld + cols(), data() + i * cols());
+    }
+
+    void store(T* dst, std::size_t ld, const row_major&) const {
+        for (std::size_t i = 0; i < rows(); i++) std::copy(data() + i * cols(), data() + (i + 1) * cols(), dst + i * ld);
+    }
+
+    void load(const T* src, std::size_t ld, const col_major&) {
+        transpose_recursive(rows(), cols(), src, ld, _data.data(), rows());
+    }
+
+    void store(T* dst, std::size_t ld, const col_major&) const {
+        transpose_recursive(cols(), rows(), _data.data(), rows(), dst, ld);
+    }
+
+    template <std::size_t B>
+    void load(const T* src, std::size_t ld, const tiled<B>&) {
+        for (std::size_t i = 0; i < rows(); i++) {
+            for (std::size_t j = 0; j < cols(); j += B) {
+                const T* row = src + i * ld + j;
+                std::copy(row, row + std::min(B, cols() - j), &(*this)(i, j));
+            }
+        }
+    }
+
+    template <std::size_t B>
+    void store(T* dst, std::size_t ld, const tiled<B>&) const {
+        for (std::size_t i = 0; i < rows(); i++) {
+            for (std::size_t j = 0; j < cols(); j += B) {
+                const T* seg = &(*this)(i, j);
+                std::copy(seg, seg + std::min(B, cols() - j), dst + i * ld + j);
+            }
+        }
+    }
+};
+
+// ------------------------------------------------- productos por layout
+
+template <typename T, typename L, typename A>
+void check_layout_product(const LayoutMatrix<T, L, A>& a, const LayoutMatrix<T, L, A>& b,
+                          const LayoutMatrix<T, L, A>& c) {
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::runtime_error("Matrix size mismatch in multiply.");
+    }
+}
+
+// row-major y col-major: el GEMM por bloques con los strides de cada uno
+template <typename T, typename A>
+void layout_multiply(const LayoutMatrix<T, row_major, A>& a, const LayoutMatrix<T, row_major, A>& b,
+                     LayoutMatrix<T, row_major, A>& c) {
+    check_layout_product(a, b, c);
+    gemm_blocked<T>(a.rows(), b.cols(), a.cols(), T(1), a.data(), a.cols(), 1, b.data(), b.cols(), 1,
+                    T(0), c.data(), c.cols(), 1, simd_micro_kernel<T>());
+}
+
+template <typename T, typename A>
+void layout_multiply(const LayoutMatrix<T, col_major, A>& a, const LayoutMatrix<T, col_major, A>& b,
+                     LayoutMatrix<T, col_major, A>& c) {
+    check_layout_product(a, b, c);
+    gemm_blocked<T>(a.rows(), b.cols(), a.cols(), T(1), a.data(), 1, a.rows(), b.data(), 1, b.rows(),
+                    T(0), c.data(), 1, c.rows(), simd_micro_kernel<T>());
+}
+
+/*
+    Producto de bloques para tiled y morton. Todos los bloques de A y de B se
+    empaquetan una sola vez (en su orden de almacenamiento) para el
+    micro-kernel; cada producto de bloques es después solo el macro-kernel:
+        C(ti, tj) = beta * C(ti, tj) + A(ti, tk) * B(tk, tj)
+*/
+template <typename T, typename L, typename A>
+class layout_tile_gemm {
+    static constexpr std::size_t B = L::tile;
+
+    const LayoutMatrix<T, L, A>& a;
+    const LayoutMatrix<T, L, A>& b;
+    LayoutMatrix<T, L, A>& c;
+    micro_kernel<T> kernel;
+    std::size_t a_panel, b_panel;  // elementos de un bloque empaquetado
+    std::vector<T> ap, bp;
+
+public:
+    layout_tile_gemm(const LayoutMatrix<T, L, A>& a, const LayoutMatrix<T, L, A>& b, LayoutMatrix<T, L, A>& c)
+        : a(a), b(b), c(c), kernel(simd_micro_kernel<T>()),
+          a_panel((B + kernel.mr - 1) / kernel.mr * kernel.mr * B),
+          b_panel((B + kernel.nr - 1) / kernel.nr * kernel.nr * B),
+          ap(a.storage_size() / (B * B) * a_panel), bp(b.storage_size() / (B * B) * b_panel) {
+        for (std::size_t t = 0; t < a.storage_size() / (B * B); t++) {
+            pack_a(B, B, a.data() + t * B * B, B, 1, kernel.mr, ap.data() + t * a_panel);
+        }
+        for (std::size_t t = 0; t < b.storage_size() / (B * B); t++) {
+            pack_b(B, B, b.data() + t * B * B, B, 1, kernel.nr, bp.data() + t * b_panel);
+        }
+    }
+
+    void operator()(std::size_t ti, std::size_t tj, std::size_t tk, T beta) {
+        gemm_macro_kernel(B, B, B, T(1), ap.data() + a.layout().tile_offset(ti, tk) / (B * B) * a_panel,
+                          bp.data() + b.layout().tile_offset(tk, tj) / (B * B) * b_panel, beta,
+                          c.data() + c.layout().tile_offset(ti, tj), B, 1, kernel);
+    }
+};
+
+// Bloques en orden row-major: bucle i-k-j sobre bloques, el bloque de A se
+// reutiliza para toda una fila de bloques de B, que está seguida en memoria
+template <typename T, std::size_t B, typename A>
+void layout_multiply(const LayoutMatrix<T, tiled<B>, A>& a, const LayoutMatrix<T, tiled<B>, A>& b,
+                     LayoutMatrix<T, tiled<B>, A>& c) {
+    check_layout_product(a, b, c);
+    layout_tile_gemm<T, tiled<B>, A> tile_gemm(a, b, c);
+    const std::size_t mt = a.layout().tile_rows, nt = b.layout().tile_cols, kt = a.layout().tile_cols;
+    if (kt == 0) std::fill(c.data(), c.data() + c.storage_size(), T(0));
+    for (std::size_t ti = 0; ti < mt; ti++) {
+        for (std::size_t tk = 0; tk < kt; tk++) {
+            for (std::size_t tj = 0; tj < nt; tj++) {
+                tile_gemm(ti, tj, tk, tk == 0 ? T(0) : T(1));
+            }
+        }
+    }
+}
+
+// Orden Z: la recursión de gemm_recursive (mitad de la mayor dimensión)
+// sobre rangos de bloques, que en este layout son cuadrantes contiguos
+template <class TileGemm>
+void morton_multiply(TileGemm& tile_gemm, std::size_t ti, std::size_t mt, std::size_t tj, std::size_t nt,
+                     std::size_t tk, std::size_t kt) {
+    if (mt == 0 || nt == 0 || kt == 0) return;
+    if (mt == 1 && nt == 1 && kt == 1) {
+        tile_gemm(ti, tj, tk, 1);
+    } else if (mt >= nt && mt >= kt) {
+        morton_multiply(tile_gemm, ti, mt / 2, tj, nt, tk, kt);
+        morton_multiply(tile_gemm, ti + mt / 2, mt - mt / 2, tj, nt, tk, kt);
+    } else if (nt >= kt) {
+        morton_multiply(tile_gemm, ti, mt, tj, nt / 2, tk, kt);
+        morton_multiply(tile_gemm, ti, mt, tj + nt / 2, nt - nt / 2, tk, kt);
+    } else {
+        morton_multiply(tile_gemm, ti, mt, tj, nt, tk, kt / 2);
+        morton_multiply(tile_gemm, ti, mt, tj, nt, tk + kt / 2, kt - kt / 2);
+    }
+}
+
+template <typename T, std::size_t B, typename A>
+void layout_multiply(const LayoutMatrix<T, morton<B>, A>& a, const LayoutMatrix<T, morton<B>, A>& b,
+                     LayoutMatrix<T, morton<B>, A>& c) {
+    check_layout_product(a, b, c);
+    std::fill(c.data(), c.data() + c.storage_size(), T(0));
+    layout_tile_gemm<T, morton<B>, A> tile_gemm(a, b, c);
+    morton_multiply(tile_gemm, 0, a.layout().tile_rows, 0, b.layout().tile_cols, 0, a.layout().tile_cols);
+}
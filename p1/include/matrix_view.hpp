@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "matrix_expr.hpp"
+
+/*
+    Vista (no propietaria) rows x cols sobre datos row-major con distancia
+    entre filas ld. Es una hoja de las expresiones: A.block(...) * B.block(...)
+    llega al GEMM como puntero + strides, sin copiar ni rellenar a cuadrado.
+
+        C.block(0, 0, m, n) = A.row_range(0, m) * B.col_range(0, n);
+
+    Copiar una vista copia el "puntero"; asignar a una vista escribe en los
+    datos a los que apunta (como los bloques de Eigen). Con T const la vista
+    es de solo lectura.
+*/
+template <typename T>
+class matrix_view : public matrix_expr<matrix_view<T>> {
+public:
+    using value_type = typename std::remove_const<T>::type;
+
+private:
+    T* p;
+    std::size_t _rows, _cols;
+    std::ptrdiff_t _ld;
+
+public:
+    matrix_view(T* p, std::size_t rows, std::size_t cols, std::ptrdiff_t ld)
+        : p(p), _rows(rows), _cols(cols), _ld(ld) {}
+
+    matrix_view(const matrix_view&) = default;
+
+    // vista de escritura -> vista de solo lectura
+    template <typename U, typename = typename std::enable_if<std::is_same<const U, T>::value>::type>
+    matrix_view(const matrix_view<U>& other) : matrix_view(other.data(), other.rows(), other.cols(), other.ld()) {}
+
+    std::size_t rows() const { return _rows; }
+    std::size_t cols() const { return _cols; }
+    std::ptrdiff_t ld() const { return _ld; }
+    T* data() const { return p; }
+    T& operator()(std::size_t i, std::size_t j) const { return p[i * _ld + j]; }
+
+    matrix_view block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const {
+        if (row + rows > _rows || col + cols > _cols) {
+            throw std::runtime_error("Block (" + std::to_string(row) + ", " + std::to_string(col) + ") of " +
+                                     std::to_string(rows) + "x" + std::to_string(cols) + " is out of a " +
+                                     std::to_string(_rows) + "x" + std::to_string(_cols) + " matrix.");
+        }
+        return matrix_view(p + row * _ld + col, rows, cols, _ld);
+    }
+
+    // Filas [first, last) y columnas [first, last)
+    matrix_view row_range(std::size_t first, std::size_t last) const { return block(first, 0, last - first, _cols); }
+    matrix_view col_range(std::size_t first, std::size_t last) const { return block(0, first, _rows, last - first); }
+
+    matrix_view& operator=(const matrix_view& other) {
+        return update(other, value_type(1), value_type(0));
+    }
+
+    template <class E>
+    matrix_view& operator=(const matrix_expr<E>& e) {
+        return update(e, value_type(1), value_type(0));
+    }
+
+    template <class E>
+    matrix_view& operator+=(const matrix_expr<E>& e) {
+        return update(e, value_type(1), value_type(1));
+    }
+
+    template <class E>
+    matrix_view& operator-=(const matrix_expr<E>& e) {
+        return update(e, value_type(-1), value_type(1));
+    }
+
+    // vista = alpha * e + beta * vista
+    template <class E>
+    matrix_view& update(const matrix_expr<E>& e, value_type alpha, value_type beta) {
+        static_assert(!std::is_const<T>::value, "Cannot assign to a read-only matrix view.");
+        const auto& x = as_expr(e.self());
+        if (x.rows() != _rows || x.cols() != _cols) {
+            throw std::runtime_error("Matrix size mismatch in assignment.");
+        }
+        assign_expr(x, alpha, beta, p, _ld);
+        return *this;
+    }
+
+    void fill(value_type value) const {
+        static_assert(!std::is_const<T>::value, "Cannot fill a read-only matrix view.");
+        for (std::size_t i = 0; i < _rows; i++) {
+            std::fill(p + i * _ld, p + i * _ld + _cols, value);
+        }
+    }
+
+    friend leaf_expr<value_type> as_expr(const matrix_view& v) {
+        return leaf_expr<value_type>(v.p, v._rows, v._cols, v._ld, 1);
+    }
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "gemm_blocked.hpp"
+#include "simd_kernels.hpp"
+
+/*
+    Productos en precisión reducida sobre el GEMM por bloques:
+
+        f32    A, B y C en float
+        bf16   A y B guardadas en bfloat16 (2 bytes), se convierten a float al
+               empaquetar y se acumula en float con el micro-kernel SIMD de float
+        int8   A y B cuantizadas a int8 con una escala por matriz, producto
+               acumulado en int32 y C = escala_a * escala_b * C_int32
+
+    El tipo de almacenamiento solo cambia lo que se lee de memoria; los
+    paneles empaquetados (en caché) ya están en el tipo de cálculo. Con int8
+    el acumulador int32 no desborda mientras k * 128 * 128 < 2^31 (cualquier
+    int8, -128 incluido): gemm_int8 rechaza k > gemm_int8_max_k.
+*/
+
+enum class precision_mode { f64, f32, bf16, int8 };
+
+inline const char* precision_name(precision_mode mode) {
+    switch (mode) {
+        case precision_mode::f32: return "f32";
+        case precision_mode::bf16: return "bf16";
+        case precision_mode::int8: return "int8";
+        default: return "f64";
+    }
+}
+
+inline precision_mode parse_precision(const std::string& name) {
+    if (name == "f64") return precision_mode::f64;
+    if (name == "f32") return precision_mode::f32;
+    if (name == "bf16") return precision_mode::bf16;
+    if (name == "int8") return precision_mode::int8;
+    throw std::runtime_error("Unknown precision mode: " + name + ".");
+}
+
+// Bytes por elemento de A y B en cada modo
+inline std::size_t precision_bytes(precision_mode mode) {
+    switch (mode) {
+        case precision_mode::f32: return 4;
+        case precision_mode::bf16: return 2;
+        case precision_mode::int8: return 1;
+        default: return 8;
+    }
+}
+
+// Los 16 bits altos de un float (mismo rango, 8 bits de mantisa)
+struct bfloat16 {
+    uint16_t bits;
+
+    bfloat16() = default;
+    explicit bfloat16(float x) : bits(round(x)) {}
+
+    explicit operator float() const {
+        uint32_t u = uint32_t(bits) << 16;
+        float x;
+        std::memcpy(&x, &u, sizeof(x));
+        return x;
+    }
+
+    // Redondeo al par más cercano; los NaN siguen siendo NaN
+    static uint16_t round(float x) {
+        uint32_t u;
+        std::memcpy(&u, &x, sizeof(u));
+        if ((u & 0x7fffffffu) > 0x7f800000u) return uint16_t((u >> 16) | 0x40);
+        u += 0x7fffu + ((u >> 16) & 1);
+        return uint16_t(u >> 16);
+    }
+};
+
+template <typename S>
+void to_bfloat16(std::size_t count, const S* src, bfloat16* dst) {
+    for (std::size_t i = 0; i < count; i++) dst[i] = bfloat16(static_cast<float>(src[i]));
+}
+
+// Cuantización simétrica: dst = round(src / escala), escala = max|src| / 127.
+// Devuelve la escala.
+template <typename S>
+float quantize_int8(std::size_t count, const S* src, int8_t* dst) {
+    double max_abs = 0;
+    for (std::size_t i = 0; i < count; i++) max_abs = std::max(max_abs, std::fabs(double(src[i])));
+    const float scale = (max_abs > 0) ? float(max_abs / 127.0) : 1.0f;
+    const float inv = 1.0f / scale;
+    for (std::size_t i = 0; i < count; i++) {
+        float q = std::nearbyint(float(src[i]) * inv);
+        dst[i] = int8_t(std::min(127.0f, std::max(-127.0f, q)));
+    }
+    return scale;
+}
+
+// ---------------------------------------------------------- micro-kernels int32
+
+#if PACS_SIMD_X86
+
+// 6 x 16 int32: 12 acumuladores ymm
+__attribute__((target("avx2")))
+inline void micro_kernel_i32_avx2_6x16(std::size_t kc, int32_t alpha, const int32_t* a, const int32_t* b,
+                                       int32_t beta, int32_t* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+    __m256i acc[6][2];
+#pragma GCC unroll 6
+    for (int i = 0; i < 6; i++) acc[i][0] = acc[i][1] = _mm256_setzero_si256();
+
+    for (std::size_t p = 0; p < kc; p++) {
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * 16));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + p * 16 + 8));
+#pragma GCC unroll 6
+        for (int i = 0; i < 6; i++) {
+            __m256i ai = _mm256_set1_epi32(a[p * 6 + i]);
+            acc[i][0] = _mm256_add_epi32(acc[i][0], _mm256_mullo_epi32(ai, b0));
+            acc[i][1] = _mm256_add_epi32(acc[i][1], _mm256_mullo_epi32(ai, b1));
+        }
+    }
+
+    for (int i = 0; i < 6; i++) {
+        int32_t tmp[16];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp), acc[i][0]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp + 8), acc[i][1]);
+        for (int j = 0; j < 16; j++) {
+            int32_t& cij = c[i * rsc + j * csc];
+            cij = (beta == 0) ? alpha * tmp[j] : alpha * tmp[j] + beta * cij;
+        }
+    }
+}
+
+#endif  // PACS_SIMD_X86
+
+// Con AVX-512 también se usa el de AVX2: vpmulld en zmm no da más productos
+// por ciclo y en la práctica el kernel de 8x32 era más lento.
+inline micro_kernel<int32_t> int32_micro_kernel() {
+#if PACS_SIMD_X86
+    if (simd_active_isa() != simd_isa::scalar) {
+        return {6, 16, &micro_kernel_i32_avx2_6x16, "avx2 6x16 int32"};
+    }
+#endif
+    return default_micro_kernel<int32_t>();
+}
+
+// ------------------------------------------------------------------ productos
+
+// C (float) = A * B con A y B en bfloat16, row-major con distancias lda, ldb, ldc
+inline void gemm_bf16(std::size_t m, std::size_t n, std::size_t k, const bfloat16* a, std::size_t lda,
+                      const bfloat16* b, std::size_t ldb, float* c, std::size_t ldc) {
+    gemm_blocked<float>(m, n, k, 1.0f, a, lda, 1, b, ldb, 1, 0.0f, c, ldc, 1, simd_micro_kernel<float>());
+}
+
+// Mayor k con el que la suma de k productos int8 x int8 cabe en int32
+constexpr std::size_t gemm_int8_max_k = (std::size_t(1) << 31) / (128 * 128) - 1;
+
+// C (int32) = A * B con A y B en int8
+inline void gemm_int8(std::size_t m, std::size_t n, std::size_t k, const int8_t* a, std::size_t lda,
+                      const int8_t* b, std::size_t ldb, int32_t* c, std::size_t ldc) {
+    if (k > gemm_int8_max_k) {
+        throw std::runtime_error("int8 GEMM with k = " + std::to_string(k) + " could overflow the int32 accumulator "
+                                 "(max k = " + std::to_string(gemm_int8_max_k) + ").");
+    }
+    gemm_blocked<int32_t>(m, n, k, 1, a, lda, 1, b, ldb, 1, 0, c, ldc, 1, int32_micro_kernel());
+}
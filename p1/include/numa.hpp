@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "thread_pool.hpp"
+
+/*
+    Topología NUMA leída de /sys/devices/system/node (sin libnuma) y un pool
+    de hilos por nodo con los hilos fijados a las CPUs de ese nodo.
+
+    La memoria se coloca por "first touch": la página va al nodo del hilo que
+    la escribe primero, así que basta con que cada nodo inicialice (y luego
+    use) su parte de los datos con sus propios hilos.
+*/
+
+struct numa_node {
+    int id;
+    std::vector<int> cpus;
+};
+
+// "0-3,8-11" -> {0, 1, 2, 3, 8, 9, 10, 11}
+inline std::vector<int> parse_cpulist(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        std::size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        for (int c = first; c <= last; c++) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+// Nodos con al menos una CPU permitida para el proceso (sched_getaffinity).
+// Sin /sys/devices/system/node se devuelve un único nodo con todas las CPUs.
+inline std::vector<numa_node> read_numa_topology() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    auto usable = [&](int cpu) { return !have_mask || CPU_ISSET(cpu, &allowed); };
+
+    std::vector<numa_node> nodes;
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (online && std::getline(online, list)) {
+        for (int id : parse_cpulist(list)) {
+            std::ifstream f("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+            std::string cpulist;
+            if (!f || !std::getline(f, cpulist)) continue;
+            numa_node node{id, {}};
+            for (int cpu : parse_cpulist(cpulist)) {
+                if (usable(cpu)) node.cpus.push_back(cpu);
+            }
+            if (!node.cpus.empty()) nodes.push_back(node);
+        }
+    }
+    if (nodes.empty()) {
+        numa_node node{0, {}};
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (have_mask ? CPU_ISSET(cpu, &allowed) : cpu < int(thread_pool::default_threads())) {
+                node.cpus.push_back(cpu);
+            }
+        }
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+inline const std::vector<numa_node>& numa_topology() {
+    static const std::vector<numa_node> nodes = read_numa_topology();
+    return nodes;
+}
+
+/*
+    Un thread_pool por nodo, con sus hilos fijados a las CPUs del nodo. Los
+    `threads` hilos (0 = una por CPU) se reparten entre nodos en proporción a
+    sus CPUs, al menos uno por nodo. Se recrean solo si cambia `threads`.
+*/
+inline std::vector<std::unique_ptr<thread_pool>>& numa_pools(std::size_t threads = 0) {
+    static std::vector<std::unique_ptr<thread_pool>> pools;
+    static std::size_t current_threads = ~std::size_t(0);
+
+    const std::vector<numa_node>& nodes = numa_topology();
+    if (pools.empty() || threads != current_threads) {
+        std::size_t total_cpus = 0;
+        for (const numa_node& node : nodes) total_cpus += node.cpus.size();
+        const std::size_t wanted = (threads == 0) ? total_cpus : threads;
+
+        pools.clear();
+        for (const numa_node& node : nodes) {
+            std::size_t n = std::max<std::size_t>(1, wanted * node.cpus.size() / total_cpus);
+            pools.emplace_back(new thread_pool(n));
+            pools.back()->pin_workers(node.cpus);
+        }
+        current_threads = threads;
+    }
+    return pools;
+}
+
+// Filas [first, last) que le tocan al nodo k: reparto proporcional a los hilos
+inline std::pair<std::size_t, std::size_t> numa_rows(std::size_t rows, std::size_t k,
+                                                     const std::vector<std::unique_ptr<thread_pool>>& pools) {
+    std::size_t total = 0, before = 0;
+    for (std::size_t i = 0; i < pools.size(); i++) {
+        if (i < k) before += pools[i]->size();
+        total += pools[i]->size();
+    }
+    return {rows * before / total, rows * (before + pools[k]->size()) / total};
+}
+
+// Envía una tarea al pool del nodo
+using numa_submit = std::function<void(std::function<void()>)>;
+
+/*
+    Lanza en cada nodo las tareas que genera submit_node(k, emit) y espera a
+    todas. Devuelve, por nodo, los segundos desde el inicio hasta que acaba su
+    última tarea (los nodos trabajan a la vez).
+*/
+inline std::vector<double> numa_parallel(std::vector<std::unique_ptr<thread_pool>>& pools,
+                                         const std::function<void(std::size_t, const numa_submit&)>& submit_node) {
+    using clock = std::chrono::steady_clock;
+    const clock::time_point start = clock::now();
+    std::vector<std::atomic<long long>> end_ns(pools.size());
+    for (auto& e : end_ns) e.store(0);
+
+    for (std::size_t k = 0; k < pools.size(); k++) {
+        thread_pool* pool = pools[k].get();
+        std::atomic<long long>* end = &end_ns[k];
+        submit_node(k, [pool, end, start](std::function<void()> task) {
+            pool->submit([task, end, start] {
+                task();
+                long long t = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+                long long prev = end->load();
+                while (prev < t && !end->compare_exchange_weak(prev, t)) {}
+            });
+        });
+    }
+    for (auto& pool : pools) pool->wait();
+
+    std::vector<double> seconds(pools.size());
+    for (std::size_t k = 0; k < pools.size(); k++) seconds[k] = end_ns[k].load() * 1e-9;
+    return seconds;
+}
+
+// Una fase (init, replicate, multiply) de un nodo
+struct numa_phase_stats {
+    std::string phase;
+    int node;
+    std::size_t threads;
+    std::size_t rows;
+    double seconds;
+    double bytes;       // tráfico de memoria mínimo de la fase
+    double flops;
+};
+
+// Una línea por fase y nodo:
+// numa <phase> node=<id> threads=... rows=... time_s=... gb_s=... gflops=...
+inline void numa_report(std::ostream& out, const std::vector<numa_phase_stats>& stats) {
+    for (const numa_phase_stats& s : stats) {
+        out << "numa " << s.phase << " node=" << s.node << " threads=" << s.threads << " rows=" << s.rows
+            << " time_s=" << s.seconds;
+        out << " gb_s=" << (s.seconds > 0 ? s.bytes / s.seconds * 1e-9 : 0.0);
+        if (s.flops > 0) out << " gflops=" << (s.seconds > 0 ? s.flops / s.seconds * 1e-9 : 0.0);
+        out << "\n";
+    }
+    out.flush();
+}
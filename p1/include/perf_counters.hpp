@@ -0,0 +1,271 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "thread_pool.hpp"
+
+/*
+    Contadores hardware leídos con perf_event_open desde el propio proceso,
+    acotados a regiones con nombre ("init", "multiply", ...), en lugar de
+    envolver todo el ejecutable con `sudo perf stat`.
+
+    Solo se cuenta espacio de usuario (exclude_kernel), que basta con
+    perf_event_paranoid <= 2, así que no hace falta root. Cada evento se abre
+    por separado: si el kernel o la CPU no lo soporta se marca como no
+    disponible y el resto sigue funcionando. Cuando hay más eventos que
+    contadores el kernel los multiplexa y los valores se escalan con
+    time_enabled / time_running.
+
+    Los FLOPs usan FP_ARITH_INST_RETIRED (solo Intel, doble precisión):
+    escalar, 128, 256 y 512 bits pesan 1, 2, 4 y 8 operaciones (una FMA ya
+    cuenta dos veces).
+
+    Hilos: cada evento se abre en el hilo que crea los contadores (con
+    inherit, así también cuentan los hilos que lance y hayan terminado, p. ej.
+    los std::async) y, por separado, en cada hilo de thread_pool::current()
+    (random_fill, BLAS, ...), que siguen vivos y con inherit no se verían
+    nunca. Una región suma todos esos hilos. Si el pool se recrea después con
+    otro número de hilos (thread_pool::shared(n)), sus hilos nuevos no se
+    cuentan.
+*/
+
+struct perf_event_spec {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+    double flop_weight;   // > 0 si el evento cuenta operaciones en coma flotante
+};
+
+// Valores acumulados de una región (ya escalados por multiplexación)
+struct perf_sample {
+    std::vector<double> values;
+    std::vector<bool> valid;
+    double seconds = 0;
+};
+
+inline bool perf_cpu_is_intel() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return false;
+    char vendor[13];
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+    vendor[12] = '\0';
+    return std::string(vendor) == "GenuineIntel";
+#else
+    return false;
+#endif
+}
+
+inline uint64_t perf_cache_config(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+inline std::vector<perf_event_spec> perf_default_events() {
+    std::vector<perf_event_spec> events = {
+        {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 0},
+        {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 0},
+        {"l1d_loads", PERF_TYPE_HW_CACHE,
+         perf_cache_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS), 0},
+        {"l1d_misses", PERF_TYPE_HW_CACHE,
+         perf_cache_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), 0},
+        {"llc_refs", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES, 0},
+        {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 0},
+        {"dtlb_misses", PERF_TYPE_HW_CACHE,
+         perf_cache_config(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), 0},
+        {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, 0},
+    };
+    if (perf_cpu_is_intel()) {
+        // FP_ARITH_INST_RETIRED: evento 0xC7, umask según el ancho
+        events.push_back({"fp_scalar_double", PERF_TYPE_RAW, 0x01c7, 1});
+        events.push_back({"fp_128b_double", PERF_TYPE_RAW, 0x04c7, 2});
+        events.push_back({"fp_256b_double", PERF_TYPE_RAW, 0x10c7, 4});
+        events.push_back({"fp_512b_double", PERF_TYPE_RAW, 0x40c7, 8});
+    }
+    return events;
+}
+
+class perf_counters {
+    struct raw_reading {
+        uint64_t value = 0, enabled = 0, running = 0;
+    };
+
+    std::vector<perf_event_spec> _events;
+    std::vector<std::vector<int>> _fds;   // [hilo][evento]; el hilo 0 es el que los creó
+    std::vector<std::pair<std::string, perf_sample>> _regions;
+
+    // pid 0 con inherit: el hilo actual y sus hijos; si no, solo el hilo tid
+    std::vector<int> open_thread(pid_t tid, bool inherit) const {
+        std::vector<int> fds(_events.size(), -1);
+        for (std::size_t i = 0; i < _events.size(); i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = _events[i].type;
+            attr.config = _events[i].config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.inherit = inherit ? 1 : 0;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+        }
+        return fds;
+    }
+
+    std::vector<std::vector<raw_reading>> read_raw() const {
+        std::vector<std::vector<raw_reading>> r(_fds.size(), std::vector<raw_reading>(_events.size()));
+        for (std::size_t t = 0; t < _fds.size(); t++) {
+            for (std::size_t i = 0; i < _events.size(); i++) {
+                if (_fds[t][i] < 0) continue;
+                uint64_t buf[3];
+                if (::read(_fds[t][i], buf, sizeof(buf)) == sizeof(buf)) {
+                    r[t][i] = {buf[0], buf[1], buf[2]};
+                }
+            }
+        }
+        return r;
+    }
+
+    perf_sample& region(const std::string& name) {
+        for (auto& r : _regions) {
+            if (r.first == name) return r.second;
+        }
+        perf_sample s;
+        s.values.assign(_events.size(), 0.0);
+        s.valid.assign(_events.size(), false);
+        _regions.emplace_back(name, s);
+        return _regions.back().second;
+    }
+
+public:
+    // Sin eventos no se abre nada (ni se crea el pool)
+    explicit perf_counters(std::vector<perf_event_spec> events = perf_default_events())
+        : _events(std::move(events)) {
+        if (_events.empty()) return;
+        // Los tids antes de abrir el hilo actual: si el pool se crease después,
+        // sus hilos heredarían los contadores y se contarían dos veces
+        std::vector<pid_t> workers = thread_pool::current().worker_tids();
+        _fds.push_back(open_thread(0, true));
+        for (pid_t tid : workers) {
+            _fds.push_back(open_thread(tid, false));
+        }
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ~perf_counters() {
+        for (const auto& thread : _fds) {
+            for (int fd : thread) {
+                if (fd >= 0) close(fd);
+            }
+        }
+    }
+
+    // true si al menos un contador se pudo abrir
+    bool available() const {
+        for (const auto& thread : _fds) {
+            for (int fd : thread) {
+                if (fd >= 0) return true;
+            }
+        }
+        return false;
+    }
+
+    const std::vector<perf_event_spec>& events() const { return _events; }
+    const std::vector<std::pair<std::string, perf_sample>>& regions() const { return _regions; }
+
+    // Mide f() y acumula los contadores en la región `name`
+    template <class F>
+    void measure(const std::string& name, F&& f) {
+        auto before = read_raw();
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        auto after = read_raw();
+
+        perf_sample& s = region(name);
+        s.seconds += std::chrono::duration<double>(t1 - t0).count();
+        for (std::size_t t = 0; t < _fds.size(); t++) {
+            for (std::size_t i = 0; i < _events.size(); i++) {
+                uint64_t running = after[t][i].running - before[t][i].running;
+                // Un hilo del pool que no ha corrido en la región no aporta nada
+                if (_fds[t][i] < 0 || running == 0) continue;
+                double scale = double(after[t][i].enabled - before[t][i].enabled) / running;
+                s.values[i] += double(after[t][i].value - before[t][i].value) * scale;
+                s.valid[i] = true;
+            }
+        }
+    }
+
+    // Valor de un evento en una región; devuelve false si no está disponible
+    bool value(const perf_sample& s, const std::string& event, double& out) const {
+        for (std::size_t i = 0; i < _events.size(); i++) {
+            if (event == _events[i].name) {
+                out = s.values[i];
+                return s.valid[i];
+            }
+        }
+        return false;
+    }
+
+    // Suma ponderada de los eventos de coma flotante
+    bool flops(const perf_sample& s, double& out) const {
+        out = 0;
+        bool any = false;
+        for (std::size_t i = 0; i < _events.size(); i++) {
+            if (_events[i].flop_weight > 0 && s.valid[i]) {
+                out += _events[i].flop_weight * s.values[i];
+                any = true;
+            }
+        }
+        return any;
+    }
+
+    // Una línea por región: contadores brutos y métricas derivadas (IPC, tasas de fallo, GFLOP/s)
+    void report(std::ostream& out) const {
+        std::ios::fmtflags flags = out.flags();
+        for (const auto& r : _regions) {
+            const perf_sample& s = r.second;
+            out << "perf " << r.first << " threads=" << _fds.size() << " time_s=" << s.seconds;
+            for (std::size_t i = 0; i < _events.size(); i++) {
+                out << " " << _events[i].name << "=";
+                if (s.valid[i]) out << std::fixed << std::setprecision(0) << s.values[i] << std::defaultfloat;
+                else out << "n/a";
+            }
+
+            double cycles, instructions, loads, l1_misses, refs, llc_misses, fp;
+            out << std::setprecision(4);
+            out << " ipc=";
+            if (value(s, "cycles", cycles) && value(s, "instructions", instructions) && cycles > 0)
+                out << instructions / cycles;
+            else out << "n/a";
+            out << " l1d_miss_rate=";
+            if (value(s, "l1d_loads", loads) && value(s, "l1d_misses", l1_misses) && loads > 0)
+                out << l1_misses / loads;
+            else out << "n/a";
+            out << " llc_miss_rate=";
+            if (value(s, "llc_refs", refs) && value(s, "llc_misses", llc_misses) && refs > 0)
+                out << llc_misses / refs;
+            else out << "n/a";
+            out << " gflops=";
+            if (flops(s, fp) && s.seconds > 0) out << fp / s.seconds * 1e-9;
+            else out << "n/a";
+            out << "\n";
+        }
+        out.flags(flags);
+    }
+};
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include "simd_kernels.hpp"
+#include "thread_pool.hpp"
+
+/*
+    Relleno aleatorio paralelo y reproducible con Philox4x32-10 (generador
+    basado en contador, Salmon et al. 2011): el elemento i de la secuencia
+    depende solo de (semilla, i), así que el resultado es el mismo con 1 hilo
+    que con 64, y cada hilo puede empezar en cualquier punto sin estado
+    compartido.
+
+        bloque b = i / K (K = 2 doubles o 4 floats por bloque de 128 bits)
+        contador = {b & 0xffffffff, b >> 32, 0, 0}, clave = semilla
+
+    Los 52 (double) o 23 (float) bits altos se convierten a [0, 1) poniendo
+    el exponente de 1.0 y restando 1, y se escalan con una multiplicación y
+    una suma separadas (sin FMA) para que la versión escalar y la AVX2 den
+    exactamente los mismos bits.
+
+    Cada hilo rellena un tramo contiguo alineado a página, de modo que con
+    la política first-touch de Linux las páginas quedan en el nodo NUMA del
+    hilo que después las recorre (los constructores de las matrices no
+    escriben en la memoria que reservan).
+*/
+
+namespace philox {
+
+constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+constexpr int rounds = 10;
+
+inline void block(uint32_t c[4], uint64_t seed) {
+    uint32_t k0 = static_cast<uint32_t>(seed), k1 = static_cast<uint32_t>(seed >> 32);
+    for (int r = 0; r < rounds; r++) {
+        uint64_t p0 = uint64_t(M0) * c[0];
+        uint64_t p1 = uint64_t(M1) * c[2];
+        uint32_t x0 = uint32_t(p1 >> 32) ^ c[1] ^ k0;
+        uint32_t x2 = uint32_t(p0 >> 32) ^ c[3] ^ k1;
+        c[1] = uint32_t(p1);
+        c[3] = uint32_t(p0);
+        c[0] = x0;
+        c[2] = x2;
+        k0 += W0;
+        k1 += W1;
+    }
+}
+
+inline double to_unit(uint32_t hi, uint32_t lo) {
+    uint64_t bits = ((uint64_t(hi) << 32 | lo) >> 12) | 0x3FF0000000000000ull;
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+}
+
+inline float to_unit(uint32_t x) {
+    uint32_t bits = (x >> 9) | 0x3F800000u;
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f - 1.0f;
+}
+
+template <typename T>
+constexpr std::size_t per_block() { return 16 / sizeof(T); }
+
+// Valores [first, first + count) de la secuencia, versión escalar
+inline void uniform_scalar(uint64_t seed, uint64_t first, std::size_t count, double lo, double span, double* dst) {
+    for (std::size_t n = 0; n < count;) {
+        uint64_t e = first + n;
+        uint64_t b = e / 2;
+        uint32_t c[4] = {uint32_t(b), uint32_t(b >> 32), 0, 0};
+        block(c, seed);
+        double v[2] = {to_unit(c[0], c[1]), to_unit(c[2], c[3])};
+        for (std::size_t w = e % 2; w < 2 && n < count; w++, n++) dst[n] = lo + span * v[w];
+    }
+}
+
+inline void uniform_scalar(uint64_t seed, uint64_t first, std::size_t count, float lo, float span, float* dst) {
+    for (std::size_t n = 0; n < count;) {
+        uint64_t e = first + n;
+        uint64_t b = e / 4;
+        uint32_t c[4] = {uint32_t(b), uint32_t(b >> 32), 0, 0};
+        block(c, seed);
+        for (std::size_t w = e % 4; w < 4 && n < count; w++, n++) dst[n] = lo + span * to_unit(c[w]);
+    }
+}
+
+#if PACS_SIMD_X86
+
+// mulhilo de 8 carriles de 32 bits por una constante
+__attribute__((target("avx2")))
+inline void mulhilo_avx2(__m256i a, __m256i m, __m256i& hi, __m256i& lo) {
+    lo = _mm256_mullo_epi32(a, m);
+    __m256i even = _mm256_mul_epu32(a, m);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+}
+
+// 8 bloques consecutivos a partir de b (requiere que b & 0xffffffff no desborde en b + 7)
+__attribute__((target("avx2")))
+inline void block_avx2(uint64_t b, uint64_t seed, __m256i r[4]) {
+    const __m256i m0 = _mm256_set1_epi32(int(M0)), m1 = _mm256_set1_epi32(int(M1));
+    __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(int(uint32_t(b))), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i c1 = _mm256_set1_epi32(int(uint32_t(b >> 32)));
+    __m256i c2 = _mm256_setzero_si256(), c3 = _mm256_setzero_si256();
+    uint32_t k0 = uint32_t(seed), k1 = uint32_t(seed >> 32);
+    for (int round = 0; round < rounds; round++) {
+        __m256i hi0, lo0, hi1, lo1;
+        mulhilo_avx2(c0, m0, hi0, lo0);
+        mulhilo_avx2(c2, m1, hi1, lo1);
+        c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(int(k0)));
+        c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(int(k1)));
+        c1 = lo1;
+        c3 = lo0;
+        k0 += W0;
+        k1 += W1;
+    }
+    r[0] = c0; r[1] = c1; r[2] = c2; r[3] = c3;
+}
+
+__attribute__((target("avx2")))
+inline __m256d to_unit_avx2(__m256i u) {
+    __m256i bits = _mm256_or_si256(_mm256_srli_epi64(u, 12), _mm256_set1_epi64x(0x3FF0000000000000ll));
+    return _mm256_sub_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(1.0));
+}
+
+__attribute__((target("avx2")))
+inline __m256 to_unit_avx2_ps(__m256i x) {
+    __m256i bits = _mm256_or_si256(_mm256_srli_epi32(x, 9), _mm256_set1_epi32(0x3F800000));
+    return _mm256_sub_ps(_mm256_castsi256_ps(bits), _mm256_set1_ps(1.0f));
+}
+
+// 16 doubles (8 bloques) en orden de elemento
+__attribute__((target("avx2")))
+inline void uniform_avx2_16(uint64_t b, uint64_t seed, double lo, double span, double* dst) {
+    __m256i r[4];
+    block_avx2(b, seed, r);
+    // Par (r0, r1) -> elemento par de cada bloque, (r2, r3) -> impar; r0 y r2 son la parte alta
+    __m256i x0 = _mm256_unpacklo_epi32(r[1], r[0]), x1 = _mm256_unpackhi_epi32(r[1], r[0]);
+    __m256i y0 = _mm256_unpacklo_epi32(r[3], r[2]), y1 = _mm256_unpackhi_epi32(r[3], r[2]);
+    __m256i p0 = _mm256_unpacklo_epi64(x0, y0), p1 = _mm256_unpackhi_epi64(x0, y0);
+    __m256i p2 = _mm256_unpacklo_epi64(x1, y1), p3 = _mm256_unpackhi_epi64(x1, y1);
+    __m256i u[4] = {_mm256_permute2x128_si256(p0, p1, 0x20), _mm256_permute2x128_si256(p2, p3, 0x20),
+                    _mm256_permute2x128_si256(p0, p1, 0x31), _mm256_permute2x128_si256(p2, p3, 0x31)};
+    const __m256d vlo = _mm256_set1_pd(lo), vspan = _mm256_set1_pd(span);
+    for (int q = 0; q < 4; q++) {
+        _mm256_storeu_pd(dst + 4 * q, _mm256_add_pd(vlo, _mm256_mul_pd(vspan, to_unit_avx2(u[q]))));
+    }
+}
+
+// 32 floats (8 bloques) en orden de elemento: traspuesta 4x8 de r
+__attribute__((target("avx2")))
+inline void uniform_avx2_32(uint64_t b, uint64_t seed, float lo, float span, float* dst) {
+    __m256i r[4];
+    block_avx2(b, seed, r);
+    const __m256 vlo = _mm256_set1_ps(lo), vspan = _mm256_set1_ps(span);
+    __m256 f[4];
+    for (int w = 0; w < 4; w++) f[w] = _mm256_add_ps(vlo, _mm256_mul_ps(vspan, to_unit_avx2_ps(r[w])));
+    __m256 t0 = _mm256_unpacklo_ps(f[0], f[1]), t1 = _mm256_unpackhi_ps(f[0], f[1]);
+    __m256 t2 = _mm256_unpacklo_ps(f[2], f[3]), t3 = _mm256_unpackhi_ps(f[2], f[3]);
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(u0, u1, 0x20));
+    _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(u2, u3, 0x20));
+    _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(u0, u1, 0x31));
+    _mm256_storeu_ps(dst + 24, _mm256_permute2f128_ps(u2, u3, 0x31));
+}
+
+inline void uniform_avx2(uint64_t seed, uint64_t b, double lo, double span, double* dst) {
+    uniform_avx2_16(b, seed, lo, span, dst);
+}
+
+inline void uniform_avx2(uint64_t seed, uint64_t b, float lo, float span, float* dst) {
+    uniform_avx2_32(b, seed, lo, span, dst);
+}
+
+#endif  // PACS_SIMD_X86
+
+// Valores [first, first + count) de la secuencia escalados a [lo, lo + span)
+template <typename T>
+void uniform(uint64_t seed, uint64_t first, std::size_t count, T lo, T span, T* dst) {
+#if PACS_SIMD_X86
+    if (simd_active_isa() != simd_isa::scalar) {
+        constexpr std::size_t K = per_block<T>(), step = 8 * K;
+        // Cabeza escalar hasta el inicio de un bloque
+        std::size_t head = std::min<std::size_t>(count, (K - first % K) % K);
+        uniform_scalar(seed, first, head, lo, span, dst);
+        std::size_t n = head;
+        for (; n + step <= count; n += step) {
+            uint64_t b = (first + n) / K;
+            if (uint32_t(b) > 0xFFFFFFF8u) break;   // el contador bajo desbordaría dentro del vector
+            uniform_avx2(seed, b, lo, span, dst + n);
+        }
+        uniform_scalar(seed, first + n, count - n, lo, span, dst + n);
+        return;
+    }
+#endif
+    uniform_scalar(seed, first, count, lo, span, dst);
+}
+
+}  // namespace philox
+
+// Semilla nueva por llamada cuando no se pide una concreta
+inline uint64_t random_seed() {
+    std::random_device rd;
+    return (uint64_t(rd()) << 32) | rd();
+}
+
+// Por debajo de este número de elementos se rellena en el hilo que llama
+constexpr std::size_t random_fill_parallel_threshold = std::size_t(1) << 16;
+
+/*
+    dst(i, j) = elemento i * cols + j de la secuencia (semilla), uniforme en
+    [min_value, max_value). ld es la distancia entre filas; con ld == cols la
+    matriz se trata como un único vector. Usa el pool compartido de hilos.
+*/
+template <typename T>
+void random_fill(T* dst, std::size_t rows, std::size_t cols, std::size_t ld, T min_value, T max_value,
+                 uint64_t seed) {
+    const T span = max_value - min_value;
+    const std::size_t total = rows * cols;
+    if (total == 0) return;
+
+    if (total < random_fill_parallel_threshold) {
+        for (std::size_t i = 0; i < rows; i++) {
+            philox::uniform(seed, uint64_t(i) * cols, cols, min_value, span, dst + i * ld);
+        }
+        return;
+    }
+
+    thread_pool& pool = thread_pool::current();
+    const std::size_t parts = pool.size();
+
+    if (ld == cols) {
+        // Tramos contiguos alineados a página (4 KiB)
+        const std::size_t page = 4096 / sizeof(T);
+        std::size_t chunk = (total + parts - 1) / parts;
+        chunk = (chunk + page - 1) / page * page;
+        for (std::size_t begin = 0; begin < total; begin += chunk) {
+            std::size_t n = std::min(chunk, total - begin);
+            pool.submit([=] { philox::uniform(seed, begin, n, min_value, span, dst + begin); });
+        }
+    } else {
+        std::size_t chunk = (rows + parts - 1) / parts;
+        for (std::size_t r0 = 0; r0 < rows; r0 += chunk) {
+            std::size_t r1 = std::min(rows, r0 + chunk);
+            pool.submit([=] {
+                for (std::size_t i = r0; i < r1; i++) {
+                    philox::uniform(seed, uint64_t(i) * cols, cols, min_value, span, dst + i * ld);
+                }
+            });
+        }
+    }
+    pool.wait();
+}
+
+template <typename T>
+void random_fill(T* dst, std::size_t count, T min_value, T max_value, uint64_t seed) {
+    random_fill(dst, 1, count, count, min_value, max_value, seed);
+}
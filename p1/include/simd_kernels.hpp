@@ -0,0 +1,550 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "gemm_blocked.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PACS_SIMD_X86 1
+#else
+#define PACS_SIMD_X86 0
+#endif
+
+/*
+    Kernels SIMD escritos a mano (multiplicación, suma y relleno) para float y
+    double. Cada variante se compila con su atributo target, de modo que un
+    único binario (compilado sin -march) contiene todas, y la que se usa se
+    elige al arrancar consultando CPUID. Fuera de x86 solo existe la versión
+    escalar. Los tres rellenos de Matrix siguen la ISA activa: fill(valor)
+    con simd_fill, fill(vector) con simd_copy y fill_random con la versión
+    AVX2 de Philox (random_fill.hpp), que con --isa=scalar pasa a la escalar.
+
+        simd_set_isa(parse_isa("avx2"));   // forzar una ISA (p.ej. para comparar)
+*/
+
+enum class simd_isa { scalar, avx2, avx512 };
+
+inline const char* isa_name(simd_isa isa) {
+    switch (isa) {
+        case simd_isa::avx2: return "avx2";
+        case simd_isa::avx512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+inline simd_isa parse_isa(const std::string& name) {
+    if (name == "scalar") return simd_isa::scalar;
+    if (name == "avx2") return simd_isa::avx2;
+    if (name == "avx512") return simd_isa::avx512;
+    throw std::runtime_error("Unknown ISA: " + name + ".");
+}
+
+inline bool isa_supported(simd_isa isa) {
+#if PACS_SIMD_X86
+    __builtin_cpu_init();
+    switch (isa) {
+        case simd_isa::avx512: return __builtin_cpu_supports("avx512f");
+        case simd_isa::avx2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        default: return true;
+    }
+#else
+    return isa == simd_isa::scalar;
+#endif
+}
+
+// Mejor ISA disponible en la CPU actual
+inline simd_isa simd_detect() {
+    if (isa_supported(simd_isa::avx512)) return simd_isa::avx512;
+    if (isa_supported(simd_isa::avx2)) return simd_isa::avx2;
+    return simd_isa::scalar;
+}
+
+inline simd_isa& simd_active_isa() {
+    static simd_isa isa = simd_detect();
+    return isa;
+}
+
+inline void simd_set_isa(simd_isa isa) {
+    if (!isa_supported(isa)) {
+        throw std::runtime_error(std::string("ISA ") + isa_name(isa) + " is not supported by this CPU.");
+    }
+    simd_active_isa() = isa;
+}
+
+#if PACS_SIMD_X86
+
+// ---------------------------------------------------------------- AVX2 + FMA
+
+// MR x (4 * NV) doubles: MR * NV acumuladores ymm (+ NV para B y 1 para A,
+// hay 16 registros). 6 x 8 es el de por defecto.
+template <int MR, int NV>
+__attribute__((target("avx2,fma")))
+inline void micro_kernel_avx2_d(std::size_t kc, double alpha, const double* a, const double* b,
+                                double beta, double* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+    constexpr int NR = NV * 4;
+    __m256d acc[MR][NV];
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) acc[i][h] = _mm256_setzero_pd();
+    }
+
+    for (std::size_t p = 0; p < kc; p++) {
+        __m256d bv[NV];
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) bv[h] = _mm256_loadu_pd(b + p * NR + h * 4);
+#pragma GCC unroll 16
+        for (int i = 0; i < MR; i++) {
+            __m256d ai = _mm256_broadcast_sd(a + p * MR + i);
+#pragma GCC unroll 4
+            for (int h = 0; h < NV; h++) acc[i][h] = _mm256_fmadd_pd(ai, bv[h], acc[i][h]);
+        }
+    }
+
+    __m256d va = _mm256_set1_pd(alpha), vb = _mm256_set1_pd(beta);
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+        for (int h = 0; h < NV; h++) {
+            __m256d r = _mm256_mul_pd(va, acc[i][h]);
+            if (csc == 1) {
+                double* ci = c + i * rsc + h * 4;
+                if (beta != 0.0) r = _mm256_fmadd_pd(vb, _mm256_loadu_pd(ci), r);
+                _mm256_storeu_pd(ci, r);
+            } else {
+                double tmp[4];
+                _mm256_storeu_pd(tmp, r);
+                for (int j = 0; j < 4; j++) {
+                    double& cij = c[i * rsc + (h * 4 + j) * csc];
+                    cij = (beta == 0.0) ? tmp[j] : tmp[j] + beta * cij;
+                }
+            }
+        }
+    }
+}
+
+// MR x (8 * NV) floats: igual que el de doubles (6 x 16 por defecto)
+template <int MR, int NV>
+__attribute__((target("avx2,fma")))
+inline void micro_kernel_avx2_s(std::size_t kc, float alpha, const float* a, const float* b,
+                                float beta, float* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+    constexpr int NR = NV * 8;
+    __m256 acc[MR][NV];
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) acc[i][h] = _mm256_setzero_ps();
+    }
+
+    for (std::size_t p = 0; p < kc; p++) {
+        __m256 bv[NV];
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) bv[h] = _mm256_loadu_ps(b + p * NR + h * 8);
+#pragma GCC unroll 16
+        for (int i = 0; i < MR; i++) {
+            __m256 ai = _mm256_broadcast_ss(a + p * MR + i);
+#pragma GCC unroll 4
+            for (int h = 0; h < NV; h++) acc[i][h] = _mm256_fmadd_ps(ai, bv[h], acc[i][h]);
+        }
+    }
+
+    __m256 va = _mm256_set1_ps(alpha), vb = _mm256_set1_ps(beta);
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+        for (int h = 0; h < NV; h++) {
+            __m256 r = _mm256_mul_ps(va, acc[i][h]);
+            if (csc == 1) {
+                float* ci = c + i * rsc + h * 8;
+                if (beta != 0.0f) r = _mm256_fmadd_ps(vb, _mm256_loadu_ps(ci), r);
+                _mm256_storeu_ps(ci, r);
+            } else {
+                float tmp[8];
+                _mm256_storeu_ps(tmp, r);
+                for (int j = 0; j < 8; j++) {
+                    float& cij = c[i * rsc + (h * 8 + j) * csc];
+                    cij = (beta == 0.0f) ? tmp[j] : tmp[j] + beta * cij;
+                }
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+inline void add_avx2(std::size_t n, const double* a, const double* b, double* c) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(c + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; i++) c[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx2")))
+inline void add_avx2(std::size_t n, const float* a, const float* b, float* c) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(c + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    for (; i < n; i++) c[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx2")))
+inline void fill_avx2(std::size_t n, double value, double* c) {
+    __m256d v = _mm256_set1_pd(value);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(c + i, v);
+    for (; i < n; i++) c[i] = value;
+}
+
+__attribute__((target("avx2")))
+inline void fill_avx2(std::size_t n, float value, float* c) {
+    __m256 v = _mm256_set1_ps(value);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(c + i, v);
+    for (; i < n; i++) c[i] = value;
+}
+
+__attribute__((target("avx2")))
+inline void copy_avx2(std::size_t n, const double* a, double* c) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(c + i, _mm256_loadu_pd(a + i));
+    for (; i < n; i++) c[i] = a[i];
+}
+
+__attribute__((target("avx2")))
+inline void copy_avx2(std::size_t n, const float* a, float* c) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm256_storeu_ps(c + i, _mm256_loadu_ps(a + i));
+    for (; i < n; i++) c[i] = a[i];
+}
+
+// ------------------------------------------------------------------ AVX-512
+
+// MR x (8 * NV) doubles: MR * NV acumuladores zmm (de 32 registros). 8 x 16
+// es el de por defecto.
+template <int MR, int NV>
+__attribute__((target("avx512f")))
+inline void micro_kernel_avx512_d(std::size_t kc, double alpha, const double* a, const double* b,
+                                  double beta, double* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+    constexpr int NR = NV * 8;
+    __m512d acc[MR][NV];
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) acc[i][h] = _mm512_setzero_pd();
+    }
+
+    for (std::size_t p = 0; p < kc; p++) {
+        __m512d bv[NV];
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) bv[h] = _mm512_loadu_pd(b + p * NR + h * 8);
+#pragma GCC unroll 16
+        for (int i = 0; i < MR; i++) {
+            __m512d ai = _mm512_set1_pd(a[p * MR + i]);
+#pragma GCC unroll 4
+            for (int h = 0; h < NV; h++) acc[i][h] = _mm512_fmadd_pd(ai, bv[h], acc[i][h]);
+        }
+    }
+
+    __m512d va = _mm512_set1_pd(alpha), vb = _mm512_set1_pd(beta);
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+        for (int h = 0; h < NV; h++) {
+            __m512d r = _mm512_mul_pd(va, acc[i][h]);
+            if (csc == 1) {
+                double* ci = c + i * rsc + h * 8;
+                if (beta != 0.0) r = _mm512_fmadd_pd(vb, _mm512_loadu_pd(ci), r);
+                _mm512_storeu_pd(ci, r);
+            } else {
+                double tmp[8];
+                _mm512_storeu_pd(tmp, r);
+                for (int j = 0; j < 8; j++) {
+                    double& cij = c[i * rsc + (h * 8 + j) * csc];
+                    cij = (beta == 0.0) ? tmp[j] : tmp[j] + beta * cij;
+                }
+            }
+        }
+    }
+}
+
+// MR x (16 * NV) floats (8 x 32 por defecto)
+template <int MR, int NV>
+__attribute__((target("avx512f")))
+inline void micro_kernel_avx512_s(std::size_t kc, float alpha, const float* a, const float* b,
+                                  float beta, float* c, std::ptrdiff_t rsc, std::ptrdiff_t csc) {
+    constexpr int NR = NV * 16;
+    __m512 acc[MR][NV];
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) acc[i][h] = _mm512_setzero_ps();
+    }
+
+    for (std::size_t p = 0; p < kc; p++) {
+        __m512 bv[NV];
+#pragma GCC unroll 4
+        for (int h = 0; h < NV; h++) bv[h] = _mm512_loadu_ps(b + p * NR + h * 16);
+#pragma GCC unroll 16
+        for (int i = 0; i < MR; i++) {
+            __m512 ai = _mm512_set1_ps(a[p * MR + i]);
+#pragma GCC unroll 4
+            for (int h = 0; h < NV; h++) acc[i][h] = _mm512_fmadd_ps(ai, bv[h], acc[i][h]);
+        }
+    }
+
+    __m512 va = _mm512_set1_ps(alpha), vb = _mm512_set1_ps(beta);
+#pragma GCC unroll 16
+    for (int i = 0; i < MR; i++) {
+        for (int h = 0; h < NV; h++) {
+            __m512 r = _mm512_mul_ps(va, acc[i][h]);
+            if (csc == 1) {
+                float* ci = c + i * rsc + h * 16;
+                if (beta != 0.0f) r = _mm512_fmadd_ps(vb, _mm512_loadu_ps(ci), r);
+                _mm512_storeu_ps(ci, r);
+            } else {
+                float tmp[16];
+                _mm512_storeu_ps(tmp, r);
+                for (int j = 0; j < 16; j++) {
+                    float& cij = c[i * rsc + (h * 16 + j) * csc];
+                    cij = (beta == 0.0f) ? tmp[j] : tmp[j] + beta * cij;
+                }
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void add_avx512(std::size_t n, const double* a, const double* b, double* c) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(c + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    for (; i < n; i++) c[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx512f")))
+inline void add_avx512(std::size_t n, const float* a, const float* b, float* c) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_storeu_ps(c + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    for (; i < n; i++) c[i] = a[i] + b[i];
+}
+
+__attribute__((target("avx512f")))
+inline void fill_avx512(std::size_t n, double value, double* c) {
+    __m512d v = _mm512_set1_pd(value);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(c + i, v);
+    for (; i < n; i++) c[i] = value;
+}
+
+__attribute__((target("avx512f")))
+inline void fill_avx512(std::size_t n, float value, float* c) {
+    __m512 v = _mm512_set1_ps(value);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_storeu_ps(c + i, v);
+    for (; i < n; i++) c[i] = value;
+}
+
+__attribute__((target("avx512f")))
+inline void copy_avx512(std::size_t n, const double* a, double* c) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(c + i, _mm512_loadu_pd(a + i));
+    for (; i < n; i++) c[i] = a[i];
+}
+
+__attribute__((target("avx512f")))
+inline void copy_avx512(std::size_t n, const float* a, float* c) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) _mm512_storeu_ps(c + i, _mm512_loadu_ps(a + i));
+    for (; i < n; i++) c[i] = a[i];
+}
+
+#endif  // PACS_SIMD_X86
+
+// ------------------------------------------------------------------ dispatch
+
+// Variantes del micro-kernel para una ISA, la de por defecto primero. El
+// autoajuste (matrix_tune) las mide todas y guarda en el perfil el nombre
+// de la mejor. Tipos sin kernel SIMD (int, long double, ...) solo tienen
+// las genéricas.
+template <typename T>
+const std::vector<micro_kernel<T>>& generic_micro_kernels() {
+    static const std::vector<micro_kernel<T>> generic = {
+        default_micro_kernel<T>(),
+        {8, 4, &micro_kernel_generic<T, 8, 4>, "generic 8x4"},
+        {4, 4, &micro_kernel_generic<T, 4, 4>, "generic 4x4"},
+    };
+    return generic;
+}
+
+template <typename T>
+const std::vector<micro_kernel<T>>& simd_micro_kernels(simd_isa) {
+    return generic_micro_kernels<T>();
+}
+
+template <>
+inline const std::vector<micro_kernel<double>>& simd_micro_kernels<double>(simd_isa isa) {
+#if PACS_SIMD_X86
+    static const std::vector<micro_kernel<double>> avx512 = {
+        {8, 16, &micro_kernel_avx512_d<8, 2>, "avx512 8x16"},
+        {6, 16, &micro_kernel_avx512_d<6, 2>, "avx512 6x16"},
+        {12, 16, &micro_kernel_avx512_d<12, 2>, "avx512 12x16"},
+        {14, 16, &micro_kernel_avx512_d<14, 2>, "avx512 14x16"},
+        {4, 24, &micro_kernel_avx512_d<4, 3>, "avx512 4x24"},
+        {8, 24, &micro_kernel_avx512_d<8, 3>, "avx512 8x24"},
+    };
+    static const std::vector<micro_kernel<double>> avx2 = {
+        {6, 8, &micro_kernel_avx2_d<6, 2>, "avx2 6x8"},
+        {4, 8, &micro_kernel_avx2_d<4, 2>, "avx2 4x8"},
+        {4, 12, &micro_kernel_avx2_d<4, 3>, "avx2 4x12"},
+        {8, 4, &micro_kernel_avx2_d<8, 1>, "avx2 8x4"},
+    };
+    switch (isa) {
+        case simd_isa::avx512: return avx512;
+        case simd_isa::avx2: return avx2;
+        default: break;
+    }
+#endif
+    return generic_micro_kernels<double>();
+}
+
+template <>
+inline const std::vector<micro_kernel<float>>& simd_micro_kernels<float>(simd_isa isa) {
+#if PACS_SIMD_X86
+    static const std::vector<micro_kernel<float>> avx512 = {
+        {8, 32, &micro_kernel_avx512_s<8, 2>, "avx512 8x32"},
+        {6, 32, &micro_kernel_avx512_s<6, 2>, "avx512 6x32"},
+        {12, 32, &micro_kernel_avx512_s<12, 2>, "avx512 12x32"},
+        {14, 32, &micro_kernel_avx512_s<14, 2>, "avx512 14x32"},
+        {4, 48, &micro_kernel_avx512_s<4, 3>, "avx512 4x48"},
+        {8, 48, &micro_kernel_avx512_s<8, 3>, "avx512 8x48"},
+    };
+    static const std::vector<micro_kernel<float>> avx2 = {
+        {6, 16, &micro_kernel_avx2_s<6, 2>, "avx2 6x16"},
+        {4, 16, &micro_kernel_avx2_s<4, 2>, "avx2 4x16"},
+        {4, 24, &micro_kernel_avx2_s<4, 3>, "avx2 4x24"},
+        {8, 8, &micro_kernel_avx2_s<8, 1>, "avx2 8x8"},
+    };
+    switch (isa) {
+        case simd_isa::avx512: return avx512;
+        case simd_isa::avx2: return avx2;
+        default: break;
+    }
+#endif
+    return generic_micro_kernels<float>();
+}
+
+// Micro-kernel fijado para una ISA (por el perfil de ajuste o con
+// simd_set_micro_kernel); fn == nullptr: el de por defecto
+template <typename T>
+struct tuned_micro_kernel {
+    simd_isa isa;
+    micro_kernel<T> kernel;
+};
+
+// Variante de la ISA activa con ese nombre ("avx512 8x16", ...)
+template <typename T>
+micro_kernel<T> find_micro_kernel(const std::string& name) {
+    for (const micro_kernel<T>& k : simd_micro_kernels<T>(simd_active_isa())) {
+        if (name == k.name) return k;
+    }
+    throw std::runtime_error("Unknown micro-kernel for ISA " + std::string(isa_name(simd_active_isa())) + ": " +
+                             name + ".");
+}
+
+template <typename T>
+tuned_micro_kernel<T>& simd_tuned_micro_kernel() {
+    // El del perfil solo vale para la ISA con que se midió: si se fuerza
+    // otra con simd_set_isa se vuelve al de por defecto
+    static tuned_micro_kernel<T> tuned = [] {
+        tuned_micro_kernel<T> t{simd_active_isa(), {0, 0, nullptr, ""}};
+        const std::string name = tuning_get<T>("kernel", "");
+        for (const micro_kernel<T>& k : simd_micro_kernels<T>(t.isa)) {
+            if (name == k.name) t.kernel = k;
+        }
+        return t;
+    }();
+    return tuned;
+}
+
+template <typename T>
+void simd_set_micro_kernel(const micro_kernel<T>& kernel) {
+    simd_tuned_micro_kernel<T>() = {simd_active_isa(), kernel};
+}
+
+// Micro-kernel de la ISA activa: el ajustado si lo hay, si no el primero
+template <typename T>
+micro_kernel<T> simd_micro_kernel() {
+    const tuned_micro_kernel<T>& tuned = simd_tuned_micro_kernel<T>();
+    if (tuned.kernel.fn && tuned.isa == simd_active_isa()) return tuned.kernel;
+    return simd_micro_kernels<T>(simd_active_isa()).front();
+}
+
+// c[i] = a[i] + b[i]
+template <typename T>
+void simd_add(std::size_t n, const T* a, const T* b, T* c) {
+    for (std::size_t i = 0; i < n; i++) c[i] = a[i] + b[i];
+}
+
+// c[i] = value
+template <typename T>
+void simd_fill(std::size_t n, T value, T* c) {
+    for (std::size_t i = 0; i < n; i++) c[i] = value;
+}
+
+// c[i] = a[i]
+template <typename T>
+void simd_copy(std::size_t n, const T* a, T* c) {
+    for (std::size_t i = 0; i < n; i++) c[i] = a[i];
+}
+
+#if PACS_SIMD_X86
+template <>
+inline void simd_add<double>(std::size_t n, const double* a, const double* b, double* c) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: add_avx512(n, a, b, c); return;
+        case simd_isa::avx2: add_avx2(n, a, b, c); return;
+        default: for (std::size_t i = 0; i < n; i++) c[i] = a[i] + b[i];
+    }
+}
+
+template <>
+inline void simd_add<float>(std::size_t n, const float* a, const float* b, float* c) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: add_avx512(n, a, b, c); return;
+        case simd_isa::avx2: add_avx2(n, a, b, c); return;
+        default: for (std::size_t i = 0; i < n; i++) c[i] = a[i] + b[i];
+    }
+}
+
+template <>
+inline void simd_fill<double>(std::size_t n, double value, double* c) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: fill_avx512(n, value, c); return;
+        case simd_isa::avx2: fill_avx2(n, value, c); return;
+        default: for (std::size_t i = 0; i < n; i++) c[i] = value;
+    }
+}
+
+template <>
+inline void simd_fill<float>(std::size_t n, float value, float* c) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: fill_avx512(n, value, c); return;
+        case simd_isa::avx2: fill_avx2(n, value, c); return;
+        default: for (std::size_t i = 0; i < n; i++) c[i] = value;
+    }
+}
+
+template <>
+inline void simd_copy<double>(std::size_t n, const double* a, double* c) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: copy_avx512(n, a, c); return;
+        case simd_isa::avx2: copy_avx2(n, a, c); return;
+        default: for (std::size_t i = 0; i < n; i++) c[i] = a[i];
+    }
+}
+
+template <>
+inline void simd_copy<float>(std::size_t n, const float* a, float* c) {
+    switch (simd_active_isa()) {
+        case simd_isa::avx512: copy_avx512(n, a, c); return;
+        case simd_isa::avx2: copy_avx2(n, a, c); return;
+        default: for (std::size_t i = 0; i < n; i++) c[i] = a[i];
+    }
+}
+#endif
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "matrix.hpp"
+#include "thread_pool.hpp"
+
+/*
+    Matrices dispersas que se combinan con Matrix<T> (densa):
+
+        csr_matrix<T>  filas comprimidas: row_ptr[i] .. row_ptr[i+1] indexa las
+                       columnas y valores de la fila i
+        csc_matrix<T>  lo mismo por columnas
+        bsr_matrix<T>  CSR de bloques densos b x b (solo se guardan los bloques
+                       con algún elemento no nulo)
+
+    Se construyen desde una matriz densa descartando los |x| <= threshold y
+    ofrecen A * x (SpMV) y A * B con B densa (SpMM), con coste proporcional a
+    nnz en vez de a n^3. CSR y BSR reparten las filas entre los hilos del pool
+    (a partes iguales de nnz) cuando hay suficiente trabajo.
+*/
+
+// Por debajo de este número de productos (nnz * columnas de B) se calcula en el hilo que llama
+constexpr std::size_t sparse_parallel_work = std::size_t(1) << 16;
+
+// Divide [0, rows) en `parts` tramos con aproximadamente el mismo número de
+// no nulos según ptr (row_ptr de CSR/BSR). Devuelve parts + 1 fronteras.
+inline std::vector<std::size_t> sparse_row_partition(const std::vector<std::size_t>& ptr, std::size_t parts) {
+    const std::size_t rows = ptr.size() - 1, nnz = ptr.back();
+    std::vector<std::size_t> bounds(parts + 1, rows);
+    bounds[0] = 0;
+    for (std::size_t p = 1; p < parts; p++) {
+        std::size_t target = nnz * p / parts;
+        std::size_t row = std::lower_bound(ptr.begin(), ptr.end(), target) - ptr.begin();
+        bounds[p] = std::max(bounds[p - 1], std::min(row, rows));
+    }
+    return bounds;
+}
+
+// f(first_row, last_row) sobre tramos equilibrados en nnz, en paralelo si work lo justifica
+template <typename F>
+void sparse_for_rows(const std::vector<std::size_t>& ptr, std::size_t work, F f) {
+    thread_pool& pool = thread_pool::current();
+    if (work < sparse_parallel_work || pool.size() == 1) {
+        f(std::size_t(0), ptr.size() - 1);
+        return;
+    }
+    std::vector<std::size_t> bounds = sparse_row_partition(ptr, pool.size());
+    for (std::size_t p = 0; p + 1 < bounds.size(); p++) {
+        if (bounds[p] == bounds[p + 1]) continue;
+        std::size_t first = bounds[p], last = bounds[p + 1];
+        pool.submit([&f, first, last] { f(first, last); });
+    }
+    pool.wait();
+}
+
+inline void check_sparse_index(std::size_t n) {
+    if (n > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Sparse dimension " + std::to_string(n) + " does not fit in 32-bit indices.");
+    }
+}
+
+// y += v * x (fila de B sobre fila de C); __restrict para que se vectorice a -O2
+template <typename T>
+inline void sparse_axpy(std::size_t n, T v, const T* __restrict x, T* __restrict y) {
+    for (std::size_t j = 0; j < n; j++) y[j] += v * x[j];
+}
+
+// y = A * x y C = A * B para cualquiera de los formatos (operator* de cada clase)
+template <class Sparse, typename T>
+std::vector<T> sparse_times_vector(const Sparse& a, const std::vector<T>& x) {
+    if (x.size() != a.cols()) {
+        throw std::runtime_error("Vector size mismatch in sparse multiply.");
+    }
+    std::vector<T> y(a.rows());
+    a.multiply(x.data(), y.data());
+    return y;
+}
+
+template <class Sparse, typename T, typename Alloc>
+Matrix<T, Alloc> sparse_times_dense(const Sparse& a, const Matrix<T, Alloc>& b) {
+    Matrix<T, Alloc> c(a.rows(), b.cols());
+    a.multiply(b, c);
+    return c;
+}
+
+// ------------------------------------------------------------------------ CSR
+
+template <typename T>
+class csr_matrix {
+    std::size_t _rows = 0, _cols = 0;
+    std::vector<std::size_t> _row_ptr{0};
+    std::vector<std::uint32_t> _col_idx;
+    std::vector<T> _values;
+
+public:
+    csr_matrix() = default;
+
+    // Se guardan los elementos con |a(i, j)| > threshold
+    template <typename Alloc>
+    static csr_matrix from_dense(const Matrix<T, Alloc>& a, T threshold = T(0)) {
+        check_sparse_index(a.cols());
+        csr_matrix s;
+        s._rows = a.rows();
+        s._cols = a.cols();
+        s._row_ptr.assign(1, 0);
+        for (std::size_t i = 0; i < a.rows(); i++) {
+            const T* row = a.data() + i * a.ld();
+            for (std::size_t j = 0; j < a.cols(); j++) {
+                if (std::abs(row[j]) > threshold) {
+                    s._col_idx.push_back(std::uint32_t(j));
+                    s._values.push_back(row[j]);
+                }
+            }
+            s._row_ptr.push_back(s._values.size());
+        }
+        return s;
+    }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> a(_rows, _cols);
+        a.fill(T(0));
+        for (std::size_t i = 0; i < _rows; i++) {
+            for (std::size_t p = _row_ptr[i]; p < _row_ptr[i + 1]; p++) a.data()[i * _cols + _col_idx[p]] = _values[p];
+        }
+        return a;
+    }
+
+    std::size_t rows() const { return _rows; }
+    std::size_t cols() const { return _cols; }
+    std::size_t nnz() const { return _values.size(); }
+    double density() const { return (_rows && _cols) ? double(nnz()) / (double(_rows) * _cols) : 0.0; }
+    const std::vector<std::size_t>& row_ptr() const { return _row_ptr; }
+    const std::vector<std::uint32_t>& col_idx() const { return _col_idx; }
+    const std::vector<T>& values() const { return _values; }
+
+    // y = A * x (SpMV), filas repartidas entre los hilos por nnz
+    void multiply(const T* x, T* y) const {
+        sparse_for_rows(_row_ptr, nnz(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                T sum = 0;
+                for (std::size_t p = _row_ptr[i]; p < _row_ptr[i + 1]; p++) sum += _values[p] * x[_col_idx[p]];
+                y[i] = sum;
+            }
+        });
+    }
+
+    // C = A * B con B densa (SpMM): C(i, :) = sum_p v_p * B(col_p, :)
+    template <typename Alloc>
+    void multiply(const Matrix<T, Alloc>& b, Matrix<T, Alloc>& c) const {
+        if (b.rows() != _cols || c.rows() != _rows || c.cols() != b.cols()) {
+            throw std::runtime_error("Matrix size mismatch in sparse multiply.");
+        }
+        const std::size_t n = b.cols();
+        sparse_for_rows(_row_ptr, nnz() * n, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                T* ci = c.data() + i * n;
+                std::fill(ci, ci + n, T(0));
+                for (std::size_t p = _row_ptr[i]; p < _row_ptr[i + 1]; p++) {
+                    sparse_axpy(n, _values[p], b.data() + std::size_t(_col_idx[p]) * n, ci);
+                }
+            }
+        });
+    }
+
+    friend std::vector<T> operator*(const csr_matrix& a, const std::vector<T>& x) {
+        return sparse_times_vector(a, x);
+    }
+
+    template <typename Alloc>
+    friend Matrix<T, Alloc> operator*(const csr_matrix& a, const Matrix<T, Alloc>& b) {
+        return sparse_times_dense(a, b);
+    }
+};
+
+// ------------------------------------------------------------------------ CSC
+
+template <typename T>
+class csc_matrix {
+    std::size_t _rows = 0, _cols = 0;
+    std::vector<std::size_t> _col_ptr{0};
+    std::vector<std::uint32_t> _row_idx;
+    std::vector<T> _values;
+
+public:
+    csc_matrix() = default;
+
+    template <typename Alloc>
+    static csc_matrix from_dense(const Matrix<T, Alloc>& a, T threshold = T(0)) {
+        check_sparse_index(a.rows());
+        csc_matrix s;
+        s._rows = a.rows();
+        s._cols = a.cols();
+        s._col_ptr.assign(1, 0);
+        for (std::size_t j = 0; j < a.cols(); j++) {
+            for (std::size_t i = 0; i < a.rows(); i++) {
+                T x = a.data()[i * a.ld() + j];
+                if (std::abs(x) > threshold) {
+                    s._row_idx.push_back(std::uint32_t(i));
+                    s._values.push_back(x);
+                }
+            }
+            s._col_ptr.push_back(s._values.size());
+        }
+        return s;
+    }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> a(_rows, _cols);
+        a.fill(T(0));
+        for (std::size_t j = 0; j < _cols; j++) {
+            for (std::size_t p = _col_ptr[j]; p < _col_ptr[j + 1]; p++) a.data()[_row_idx[p] * _cols + j] = _values[p];
+        }
+        return a;
+    }
+
+    std::size_t rows() const { return _rows; }
+    std::size_t cols() const { return _cols; }
+    std::size_t nnz() const { return _values.size(); }
+    double density() const { return (_rows && _cols) ? double(nnz()) / (double(_rows) * _cols) : 0.0; }
+    const std::vector<std::size_t>& col_ptr() const { return _col_ptr; }
+    const std::vector<std::uint32_t>& row_idx() const { return _row_idx; }
+    const std::vector<T>& values() const { return _values; }
+
+    // y = A * x recorriendo columnas (y += x_j * A(:, j)). Las escrituras en
+    // y se cruzan entre columnas, así que no se reparte entre hilos; para
+    // SpMV en paralelo, CSR.
+    void multiply(const T* x, T* y) const {
+        std::fill(y, y + _rows, T(0));
+        for (std::size_t j = 0; j < _cols; j++) {
+            const T xj = x[j];
+            for (std::size_t p = _col_ptr[j]; p < _col_ptr[j + 1]; p++) y[_row_idx[p]] += _values[p] * xj;
+        }
+    }
+
+    // C = A * B con B densa: C(i, :) += A(i, j) * B(j, :)
+    template <typename Alloc>
+    void multiply(const Matrix<T, Alloc>& b, Matrix<T, Alloc>& c) const {
+        if (b.rows() != _cols || c.rows() != _rows || c.cols() != b.cols()) {
+            throw std::runtime_error("Matrix size mismatch in sparse multiply.");
+        }
+        const std::size_t n = b.cols();
+        c.fill(T(0));
+        for (std::size_t j = 0; j < _cols; j++) {
+            const T* bj = b.data() + j * n;
+            for (std::size_t p = _col_ptr[j]; p < _col_ptr[j + 1]; p++) {
+                sparse_axpy(n, _values[p], bj, c.data() + std::size_t(_row_idx[p]) * n);
+            }
+        }
+    }
+
+    friend std::vector<T> operator*(const csc_matrix& a, const std::vector<T>& x) {
+        return sparse_times_vector(a, x);
+    }
+
+    template <typename Alloc>
+    friend Matrix<T, Alloc> operator*(const csc_matrix& a, const Matrix<T, Alloc>& b) {
+        return sparse_times_dense(a, b);
+    }
+};
+
+// ------------------------------------------------------------------------ BSR
+
+template <typename T>
+class bsr_matrix {
+    std::size_t _rows = 0, _cols = 0, _block = 1;
+    std::vector<std::size_t> _block_ptr{0};      // por fila de bloques
+    std::vector<std::uint32_t> _block_col;       // columna de bloque
+    std::vector<T> _values;                      // bloques b x b row-major, seguidos
+
+public:
+    bsr_matrix() = default;
+
+    // Bloques b x b; los bordes se rellenan con ceros si rows/cols no son múltiplo de b
+    template <typename Alloc>
+    static bsr_matrix from_dense(const Matrix<T, Alloc>& a, std::size_t block, T threshold = T(0)) {
+        if (block == 0) {
+            throw std::runtime_error("Block size must be positive.");
+        }
+        check_sparse_index(a.cols());
+        bsr_matrix s;
+        s._rows = a.rows();
+        s._cols = a.cols();
+        s._block = block;
+        s._block_ptr.assign(1, 0);
+        const std::size_t b = block;
+        for (std::size_t i0 = 0; i0 < a.rows(); i0 += b) {
+            const std::size_t h = std::min(b, a.rows() - i0);
+            for (std::size_t j0 = 0; j0 < a.cols(); j0 += b) {
+                const std::size_t w = std::min(b, a.cols() - j0);
+                bool keep = false;
+                for (std::size_t i = 0; i < h && !keep; i++) {
+                    for (std::size_t j = 0; j < w && !keep; j++) {
+                        keep = std::abs(a.data()[(i0 + i) * a.ld() + j0 + j]) > threshold;
+                    }
+                }
+                if (!keep) continue;
+                s._block_col.push_back(std::uint32_t(j0 / b));
+                std::size_t base = s._values.size();
+                s._values.resize(base + b * b, T(0));
+                for (std::size_t i = 0; i < h; i++) {
+                    for (std::size_t j = 0; j < w; j++) {
+                        T x = a.data()[(i0 + i) * a.ld() + j0 + j];
+                        if (std::abs(x) > threshold) s._values[base + i * b + j] = x;
+                    }
+                }
+            }
+            s._block_ptr.push_back(s._block_col.size());
+        }
+        return s;
+    }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> a(_rows, _cols);
+        a.fill(T(0));
+        const std::size_t b = _block;
+        for (std::size_t bi = 0; bi + 1 < _block_ptr.size(); bi++) {
+            for (std::size_t p = _block_ptr[bi]; p < _block_ptr[bi + 1]; p++) {
+                const std::size_t i0 = bi * b, j0 = std::size_t(_block_col[p]) * b;
+                for (std::size_t i = 0; i < std::min(b, _rows - i0); i++) {
+                    for (std::size_t j = 0; j < std::min(b, _cols - j0); j++) {
+                        a.data()[(i0 + i) * _cols + j0 + j] = _values[p * b * b + i * b + j];
+                    }
+                }
+            }
+        }
+        return a;
+    }
+
+    std::size_t rows() const { return _rows; }
+    std::size_t cols() const { return _cols; }
+    std::size_t block() const { return _block; }
+    std::size_t blocks() const { return _block_col.size(); }
+    // Elementos guardados (incluye los ceros dentro de los bloques)
+    std::size_t stored() const { return _values.size(); }
+
+    // y = A * x; cada bloque es un pequeño GEMV denso
+    void multiply(const T* x, T* y) const {
+        const std::size_t b = _block;
+        sparse_for_rows(_block_ptr, stored(), [&](std::size_t first, std::size_t last) {
+            std::vector<T> acc(b);
+            for (std::size_t bi = first; bi < last; bi++) {
+                const std::size_t i0 = bi * b, h = std::min(b, _rows - i0);
+                std::fill(acc.begin(), acc.end(), T(0));
+                for (std::size_t p = _block_ptr[bi]; p < _block_ptr[bi + 1]; p++) {
+                    const std::size_t j0 = std::size_t(_block_col[p]) * b, w = std::min(b, _cols - j0);
+                    const T* blk = _values.data() + p * b * b;
+                    for (std::size_t i = 0; i < h; i++) {
+                        T sum = 0;
+                        for (std::size_t j = 0; j < w; j++) sum += blk[i * b + j] * x[j0 + j];
+                        acc[i] += sum;
+                    }
+                }
+                std::copy(acc.begin(), acc.begin() + h, y + i0);
+            }
+        });
+    }
+
+    // C = A * B con B densa: cada bloque actualiza b filas de C con b filas de B
+    template <typename Alloc>
+    void multiply(const Matrix<T, Alloc>& bm, Matrix<T, Alloc>& c) const {
+        if (bm.rows() != _cols || c.rows() != _rows || c.cols() != bm.cols()) {
+            throw std::runtime_error("Matrix size mismatch in sparse multiply.");
+        }
+        const std::size_t b = _block, n = bm.cols();
+        sparse_for_rows(_block_ptr, stored() * n, [&](std::size_t first, std::size_t last) {
+            for (std::size_t bi = first; bi < last; bi++) {
+                const std::size_t i0 = bi * b, h = std::min(b, _rows - i0);
+                std::fill(c.data() + i0 * n, c.data() + (i0 + h) * n, T(0));
+                for (std::size_t p = _block_ptr[bi]; p < _block_ptr[bi + 1]; p++) {
+                    const std::size_t j0 = std::size_t(_block_col[p]) * b, w = std::min(b, _cols - j0);
+                    const T* blk = _values.data() + p * b * b;
+                    for (std::size_t i = 0; i < h; i++) {
+                        T* ci = c.data() + (i0 + i) * n;
+                        for (std::size_t j = 0; j < w; j++) {
+                            const T v = blk[i * b + j];
+                            if (v != T(0)) sparse_axpy(n, v, bm.data() + (j0 + j) * n, ci);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    friend std::vector<T> operator*(const bsr_matrix& a, const std::vector<T>& x) {
+        return sparse_times_vector(a, x);
+    }
+
+    template <typename Alloc>
+    friend Matrix<T, Alloc> operator*(const bsr_matrix& a, const Matrix<T, Alloc>& b) {
+        return sparse_times_dense(a, b);
+    }
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "gemm_blocked.hpp"
+
+/*
+    Strassen-Winograd (7 productos, 15 sumas por nivel) para matrices
+    cuadradas row-major con leading dimension:
+
+        C = A * B      A, B, C: n x n
+
+    Por debajo de `crossover` se usa el GEMM por bloques. Si n es impar se
+    aplica peeling dinámico: la parte (n-1) x (n-1) va por recursión y la
+    última fila/columna se corrige con productos de rango pequeño.
+
+    Orden de operaciones de Douglas et al. (1994): solo dos temporales de
+    tamaño (n/2) x (n/2) por nivel; el resto vive en los cuadrantes de C.
+*/
+
+// c = a + b  (h x h, cada una con su leading dimension)
+template <typename T>
+void strassen_add(std::size_t h, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb,
+                  T* c, std::ptrdiff_t ldc) {
+    for (std::size_t i = 0; i < h; i++) {
+        for (std::size_t j = 0; j < h; j++) {
+            c[i * ldc + j] = a[i * lda + j] + b[i * ldb + j];
+        }
+    }
+}
+
+// c = a - b
+template <typename T>
+void strassen_sub(std::size_t h, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb,
+                  T* c, std::ptrdiff_t ldc) {
+    for (std::size_t i = 0; i < h; i++) {
+        for (std::size_t j = 0; j < h; j++) {
+            c[i * ldc + j] = a[i * lda + j] - b[i * ldb + j];
+        }
+    }
+}
+
+template <typename T>
+void strassen_winograd(std::size_t n, const T* a, std::ptrdiff_t lda, const T* b, std::ptrdiff_t ldb,
+                       T* c, std::ptrdiff_t ldc, std::size_t crossover,
+                       const micro_kernel<T>& kernel = default_micro_kernel<T>()) {
+    if (n <= std::max<std::size_t>(crossover, 2)) {
+        gemm_blocked<T>(n, n, n, T(1), a, lda, 1, b, ldb, 1, T(0), c, ldc, 1, kernel);
+        return;
+    }
+
+    if (n % 2 == 1) {
+        // Peeling dinámico
+        std::size_t e = n - 1;
+        strassen_winograd(e, a, lda, b, ldb, c, ldc, crossover, kernel);
+        // C11 += a12 * b21  (rango 1)
+        gemm_blocked<T>(e, e, 1, T(1), a + e, lda, 1, b + e * ldb, ldb, 1, T(1), c, ldc, 1, kernel);
+        // última columna de C (filas 0..e-1) y última fila completa
+        gemm_blocked<T>(e, 1, n, T(1), a, lda, 1, b + e, ldb, 1, T(0), c + e, ldc, 1, kernel);
+        gemm_blocked<T>(1, n, n, T(1), a + e * lda, lda, 1, b, ldb, 1, T(0), c + e * ldc, ldc, 1, kernel);
+        return;
+    }
+
+    const std::size_t h = n / 2;
+    const T *a11 = a, *a12 = a + h, *a21 = a + h * lda, *a22 = a + h * lda + h;
+    const T *b11 = b, *b12 = b + h, *b21 = b + h * ldb, *b22 = b + h * ldb + h;
+    T *c11 = c, *c12 = c + h, *c21 = c + h * ldc, *c22 = c + h * ldc + h;
+
+    std::vector<T> xv(h * h), yv(h * h);
+    T* x = xv.data();
+    T* y = yv.data();
+    const std::ptrdiff_t ld = h;
+
+    strassen_sub(h, a11, lda, a21, lda, x, ld);                        // S3
+    strassen_sub(h, b22, ldb, b12, ldb, y, ld);                        // T3
+    strassen_winograd(h, x, ld, y, ld, c21, ldc, crossover, kernel);   // P7
+
+    strassen_add(h, a21, lda, a22, lda, x, ld);                        // S1
+    strassen_sub(h, b12, ldb, b11, ldb, y, ld);                        // T1
+    strassen_winograd(h, x, ld, y, ld, c22, ldc, crossover, kernel);   // P5
+
+    strassen_sub(h, x, ld, a11, lda, x, ld);                           // S2
+    strassen_sub(h, b22, ldb, y, ld, y, ld);                           // T2
+    strassen_winograd(h, x, ld, y, ld, c12, ldc, crossover, kernel);   // P6
+
+    strassen_sub(h, a12, lda, x, ld, x, ld);                           // S4
+    strassen_winograd(h, x, ld, b22, ldb, c11, ldc, crossover, kernel); // P3
+
+    strassen_winograd(h, a11, lda, b11, ldb, x, ld, crossover, kernel); // P1
+
+    strassen_add(h, x, ld, c12, ldc, c12, ldc);                        // U2 = P1 + P6
+    strassen_add(h, c12, ldc, c21, ldc, c21, ldc);                     // U3 = U2 + P7
+    strassen_add(h, c12, ldc, c22, ldc, c12, ldc);                     // U4 = U2 + P5
+    strassen_add(h, c21, ldc, c22, ldc, c22, ldc);                     // C22 = U3 + P5
+    strassen_add(h, c12, ldc, c11, ldc, c12, ldc);                     // C12 = U4 + P3
+
+    strassen_sub(h, y, ld, b21, ldb, y, ld);                           // T4
+    strassen_winograd(h, a22, lda, y, ld, c11, ldc, crossover, kernel); // P4
+    strassen_sub(h, c21, ldc, c11, ldc, c21, ldc);                     // C21 = U3 - P4
+
+    strassen_winograd(h, a12, lda, b21, ldb, c11, ldc, crossover, kernel); // P2
+    strassen_add(h, x, ld, c11, ldc, c11, ldc);                        // C11 = P1 + P2
+}
+
+// Error de un producto frente a otro de referencia (mismo tamaño, contiguo).
+struct product_error {
+    double max_abs;    // max |C - C_ref|
+    double max_rel;    // max |C - C_ref| / max |C_ref|
+    double frobenius;  // ||C - C_ref||_F / ||C_ref||_F
+};
+
+template <typename T>
+product_error compare_products(std::size_t count, const T* c, const T* c_ref) {
+    double max_abs = 0, max_ref = 0, diff2 = 0, ref2 = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        double d = std::fabs(double(c[i]) - double(c_ref[i]));
+        double r = std::fabs(double(c_ref[i]));
+        max_abs = std::max(max_abs, d);
+        max_ref = std::max(max_ref, r);
+        diff2 += d * d;
+        ref2 += r * r;
+    }
+    return {max_abs, max_ref > 0 ? max_abs / max_ref : max_abs,
+            ref2 > 0 ? std::sqrt(diff2 / ref2) : std::sqrt(diff2)};
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "gemm_blocked.hpp"
+#include "matrix.hpp"
+#include "simd_kernels.hpp"
+#include "transport.hpp"
+
+/*
+    Producto distribuido entre procesos: SUMMA (Scalable Universal Matrix
+    Multiplication Algorithm) sobre una distribución 2D bloque-cíclica.
+
+    Los procesos forman una malla pr x pc (rango = fila * pc + columna) y el
+    bloque (I, J) de nb x nb de cada matriz vive en el proceso (I % pr,
+    J % pc). Cada proceso guarda sus bloques juntos en una Matrix<T> local:
+    el bloque I de filas va a las filas locales (I / pr) * nb.
+
+    Para cada bloque K de la dimensión común:
+        - la columna de procesos K % pc difunde por su fila de la malla su
+          panel de A (filas locales x bloque K de columnas)
+        - la fila de procesos K % pr difunde por su columna de la malla su
+          panel de B (bloque K de filas x columnas locales)
+        - cada proceso suma el producto de los dos paneles a su C local con
+          gemm_blocked y el micro-kernel SIMD
+    Cada proceso recibe (pr + pc) / p del total de A y B, en vez de todo,
+    y el producto local es un GEMM grande de nivel 3.
+
+    distributed_multiply reparte a y b desde el proceso que llama (rango 0),
+    lanza los demás rangos con run_processes y devuelve C reunida en él.
+*/
+
+constexpr std::size_t summa_block = 256;
+
+// Filas (o columnas) de n que caen en el proceso p de np, en bloques de nb
+inline std::size_t cyclic_local_size(std::size_t n, std::size_t nb, std::size_t np, std::size_t p) {
+    const std::size_t blocks = (n + nb - 1) / nb;
+    std::size_t size = 0;
+    for (std::size_t i = p; i < blocks; i += np) size += std::min(nb, n - i * nb);
+    return size;
+}
+
+// Malla lo más cuadrada posible: pr el mayor divisor de procs <= sqrt(procs)
+inline void summa_grid(std::size_t procs, std::size_t& pr, std::size_t& pc) {
+    pr = std::max<std::size_t>(1, std::size_t(std::sqrt(double(procs))));
+    while (procs % pr) pr--;
+    pc = procs / pr;
+}
+
+template <typename T>
+class block_cyclic_matrix
+{
+  public:
+  std::size_t rows, cols, nb;
+  std::size_t pr, pc, prow, pcol;
+  Matrix<T> local;
+
+  block_cyclic_matrix(std::size_t rows, std::size_t cols, std::size_t nb, std::size_t pr, std::size_t pc,
+                      std::size_t rank)
+      : rows(rows), cols(cols), nb(nb), pr(pr), pc(pc), prow(rank / pc), pcol(rank % pc),
+        local(cyclic_local_size(rows, nb, pr, rank / pc), cyclic_local_size(cols, nb, pc, rank % pc)) {
+    if (nb == 0) throw std::runtime_error("Block size must be positive.");
+  }
+
+  // f(fila global, columna global, fila local, columna local, alto, ancho)
+  // para cada bloque del proceso (p, q)
+  template <typename F>
+  void for_each_block(std::size_t p, std::size_t q, F f) const {
+    for (std::size_t i = p * nb, li = 0; i < rows; i += pr * nb, li += nb) {
+      for (std::size_t j = q * nb, lj = 0; j < cols; j += pc * nb, lj += nb) {
+        f(i, j, li, lj, std::min(nb, rows - i), std::min(nb, cols - j));
+      }
+    }
+  }
+
+  // El rango root envía a cada proceso sus bloques de global (solo se lee en root)
+  void scatter(const Matrix<T>* global, transport& t, std::size_t root = 0) {
+    if (t.rank() != root) {
+      t.recv(root, local.data(), local.count() * sizeof(T));
+      return;
+    }
+    for (std::size_t r = 0; r < t.size(); r++) {
+      Matrix<T> part(cyclic_local_size(rows, nb, pr, r / pc), cyclic_local_size(cols, nb, pc, r % pc));
+      for_each_block(r / pc, r % pc, [&](std::size_t i, std::size_t j, std::size_t li, std::size_t lj,
+                                         std::size_t h, std::size_t w) {
+        for (std::size_t x = 0; x < h; x++) {
+          std::copy_n(global->data() + (i + x) * global->ld() + j, w, part.data() + (li + x) * part.ld() + lj);
+        }
+      });
+      if (r == root) std::swap(local, part);
+      else t.send(r, part.data(), part.count() * sizeof(T));
+    }
+  }
+
+  // Inversa de scatter: root reúne los bloques de todos en global
+  void gather(Matrix<T>* global, transport& t, std::size_t root = 0) const {
+    if (t.rank() != root) {
+      t.send(root, local.data(), local.count() * sizeof(T));
+      return;
+    }
+    for (std::size_t r = 0; r < t.size(); r++) {
+      Matrix<T> part(cyclic_local_size(rows, nb, pr, r / pc), cyclic_local_size(cols, nb, pc, r % pc));
+      if (r == root) part = local;
+      else t.recv(r, part.data(), part.count() * sizeof(T));
+      for_each_block(r / pc, r % pc, [&](std::size_t i, std::size_t j, std::size_t li, std::size_t lj,
+                                         std::size_t h, std::size_t w) {
+        for (std::size_t x = 0; x < h; x++) {
+          std::copy_n(part.data() + (li + x) * part.ld() + lj, w, global->data() + (i + x) * global->ld() + j);
+        }
+      });
+    }
+  }
+};
+
+// C = A B con las tres matrices en la misma malla y el mismo nb
+template <typename T>
+void summa_multiply(const block_cyclic_matrix<T>& a, const block_cyclic_matrix<T>& b, block_cyclic_matrix<T>& c,
+                    transport& t) {
+    if (a.cols != b.rows || c.rows != a.rows || c.cols != b.cols) {
+        throw std::runtime_error("Matrix size mismatch in SUMMA.");
+    }
+    if (a.nb != b.nb || a.nb != c.nb || a.pr != c.pr || a.pc != c.pc || b.pr != c.pr || b.pc != c.pc) {
+        throw std::runtime_error("SUMMA needs the same block size and process grid for all matrices.");
+    }
+    const std::size_t nb = c.nb, pr = c.pr, pc = c.pc;
+    const std::size_t m = c.local.rows(), n = c.local.cols();
+
+    std::vector<std::size_t> row_group(pc), col_group(pr);
+    for (std::size_t q = 0; q < pc; q++) row_group[q] = c.prow * pc + q;
+    for (std::size_t p = 0; p < pr; p++) col_group[p] = p * pc + c.pcol;
+
+    std::fill_n(c.local.data(), c.local.count(), T(0));
+    std::vector<T> apanel(m * nb), bpanel(nb * n);
+    const micro_kernel<T> kernel = simd_micro_kernel<T>();
+
+    for (std::size_t k0 = 0, kblock = 0; k0 < a.cols; k0 += nb, kblock++) {
+        const std::size_t kb = std::min(nb, a.cols - k0);
+
+        // Panel de A: columnas locales (kblock / pc) * nb del dueño, empaquetadas con ld = kb
+        if (c.pcol == kblock % pc) {
+            const std::size_t lj = kblock / pc * nb;
+            for (std::size_t i = 0; i < m; i++) {
+                std::copy_n(a.local.data() + i * a.local.ld() + lj, kb, apanel.data() + i * kb);
+            }
+        }
+        t.broadcast(apanel.data(), m * kb * sizeof(T), row_group, kblock % pc);
+
+        // Panel de B: filas locales (kblock / pr) * nb del dueño, ya contiguas
+        if (c.prow == kblock % pr) {
+            std::copy_n(b.local.data() + kblock / pr * nb * b.local.ld(), kb * n, bpanel.data());
+        }
+        t.broadcast(bpanel.data(), kb * n * sizeof(T), col_group, kblock % pr);
+
+        gemm_blocked<T>(m, n, kb, T(1), apanel.data(), kb, 1, bpanel.data(), n, 1, T(1), c.local.data(),
+                        c.local.ld(), 1, kernel);
+    }
+}
+
+struct summa_stats {
+    std::size_t procs = 1, grid_rows = 1, grid_cols = 1;
+    double distribute_s = 0;   // scatter de A y B
+    double multiply_s = 0;     // summa_multiply, entre barreras
+    double collect_s = 0;      // gather de C
+    double comm_s = 0;         // máximo entre rangos del tiempo en send/recv durante el producto
+    double bytes = 0;          // bytes enviados entre todos los rangos durante el producto
+};
+
+template <typename T>
+Matrix<T> distributed_multiply(const Matrix<T>& a, const Matrix<T>& b, std::size_t procs,
+                               transport_kind kind = transport_kind::shm, std::size_t nb = summa_block,
+                               summa_stats* stats = nullptr) {
+    if (a.cols() != b.rows()) throw std::runtime_error("Matrix size mismatch in multiply.");
+    procs = std::max<std::size_t>(1, procs);
+    std::size_t pr, pc;
+    summa_grid(procs, pr, pc);
+
+    Matrix<T> result(a.rows(), b.cols());
+    summa_stats st;
+    run_processes(procs, kind, [&](transport& t) {
+        auto seconds = [] {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        };
+        const bool root = t.rank() == 0;
+        block_cyclic_matrix<T> la(a.rows(), a.cols(), nb, pr, pc, t.rank());
+        block_cyclic_matrix<T> lb(b.rows(), b.cols(), nb, pr, pc, t.rank());
+        block_cyclic_matrix<T> lc(a.rows(), b.cols(), nb, pr, pc, t.rank());
+
+        t.barrier();
+        double start = seconds();
+        la.scatter(root ? &a : nullptr, t);
+        lb.scatter(root ? &b : nullptr, t);
+        t.barrier();
+        const double distributed = seconds();
+
+        t.reset_stats();
+        summa_multiply(la, lb, lc, t);
+        const double comm = t.comm_seconds();
+        const double bytes = double(t.bytes_sent());
+        t.barrier();
+        const double multiplied = seconds();
+
+        lc.gather(root ? &result : nullptr, t);
+        t.barrier();
+        const double collected = seconds();
+
+        const double comm_max = t.max_all(comm);
+        const double bytes_sum = t.sum_all(bytes);
+        if (root) {
+            st.distribute_s = distributed - start;
+            st.multiply_s = multiplied - distributed;
+            st.collect_s = collected - multiplied;
+            st.comm_s = comm_max;
+            st.bytes = bytes_sum;
+        }
+    });
+
+    st.procs = procs;
+    st.grid_rows = pr;
+    st.grid_cols = pc;
+    if (stats) *stats = st;
+    return result;
+}
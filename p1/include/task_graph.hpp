@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "thread_pool.hpp"
+
+/*
+    Grafo de tareas (DAG) sobre thread_pool: cada tarea se añade con la
+    lista de tareas de las que depende y run() la envía al pool en cuanto
+    han terminado todas ellas. Así un algoritmo por bloques (LU, Cholesky)
+    se describe con sus dependencias de datos reales y no con barreras por
+    iteración: las actualizaciones de un paso se solapan con el panel del
+    siguiente.
+
+    Al terminar una tarea, el hilo continúa directamente con la primera de
+    sus sucesoras que queda lista (y envía al pool las demás). En los
+    algoritmos por bloques la primera sucesora es la del camino crítico
+    (el siguiente panel), que así no espera detrás de la cola.
+*/
+class task_graph
+{
+  struct node {
+    std::function<void()> fn;
+    std::vector<std::size_t> next;
+    std::size_t deps = 0;
+    std::atomic<std::size_t> remaining{0};
+  };
+
+  std::deque<node> _nodes;  // deque: node no se puede mover (atomic)
+
+  void execute(thread_pool& pool, std::size_t id) {
+    for (;;) {
+      _nodes[id].fn();
+      std::size_t follow = none;
+      for (std::size_t s : _nodes[id].next) {
+        if (_nodes[s].remaining.fetch_sub(1) != 1) continue;
+        if (follow == none) {
+          follow = s;
+        } else {
+          pool.submit([this, &pool, s] { execute(pool, s); });
+        }
+      }
+      if (follow == none) return;
+      id = follow;
+    }
+  }
+
+  public:
+  // Identificador "sin tarea": se ignora en las listas de dependencias
+  static constexpr std::size_t none = std::size_t(-1);
+
+  std::size_t add(std::function<void()> fn, const std::vector<std::size_t>& after = {}) {
+    const std::size_t id = _nodes.size();
+    _nodes.emplace_back();
+    _nodes.back().fn = std::move(fn);
+    for (std::size_t d : after) {
+      if (d == none) continue;
+      _nodes[d].next.push_back(id);
+      _nodes.back().deps++;
+    }
+    return id;
+  }
+
+  std::size_t size() const { return _nodes.size(); }
+
+  // Ejecuta todas las tareas y espera a que terminen (también desde una
+  // tarea del mismo pool: su wait() ejecuta tareas mientras espera)
+  void run(thread_pool& pool = thread_pool::current()) {
+    for (node& n : _nodes) n.remaining = n.deps;
+    for (std::size_t id = 0; id < _nodes.size(); id++) {
+      if (_nodes[id].deps == 0) pool.submit([this, &pool, id] { execute(pool, id); });
+    }
+    pool.wait();
+  }
+};
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <queue>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/*
+    Pool de hilos persistente (misma interfaz que el de p4: submit + wait).
+    Los hilos se crean una vez y duermen en una variable de condición.
+
+    Las tareas se agrupan en lotes: cada hilo externo que llama a submit
+    tiene el suyo, y lo que envía una tarea desde un hilo del pool forma un
+    sublote de la tarea que lo envía (y cuenta también en su lote). wait()
+    espera a que termine el lote de quien llama, no todo lo que haya en la
+    cola, así que varios hilos pueden usar el mismo pool a la vez. Llamado
+    desde una tarea, wait() no se bloquea con el hilo parado: ejecuta tareas
+    de la cola hasta que acaba su sublote, sin riesgo de interbloqueo.
+
+    Si una tarea lanza una excepción, la tarea cuenta como terminada y la
+    primera excepción de cada lote (sublotes incluidos) se relanza en el
+    wait() que espera ese lote; el resto del lote se ejecuta igualmente.
+*/
+class thread_pool
+{
+  struct batch {
+    std::shared_ptr<batch> parent;
+    std::size_t pending = 0;            // tareas en cola + en ejecución, sublotes incluidos
+    std::exception_ptr error;           // primera excepción del lote, para wait()
+  };
+
+  struct task {
+    std::function<void()> fn;
+    std::shared_ptr<batch> owner;
+  };
+
+  // Tarea que ejecuta el hilo actual, si es de un pool
+  struct running {
+    thread_pool* pool;
+    std::shared_ptr<batch> owner;
+    std::shared_ptr<batch> children;    // lote de lo que envía esta tarea
+  };
+
+  std::mutex _mtx;
+  std::condition_variable _work_cond;   // hay trabajo o hay que terminar
+  std::condition_variable _done_cond;   // ha terminado algún lote
+  std::queue<task> _work_queue;
+  std::vector<std::thread> _threads;
+  std::vector<pid_t> _tids;             // id del kernel de cada hilo (para perf_event_open)
+  std::map<std::thread::id, std::shared_ptr<batch>> _callers;   // lote de cada hilo externo
+  std::size_t _helpers = 0;             // tareas dormidas en wait() (despertarlas si llega trabajo)
+  bool _done = false;
+
+  static running*& current_task()
+  {
+    static thread_local running* r = nullptr;
+    return r;
+  }
+
+  // Lote al que van las tareas que envía el hilo actual (con _mtx tomado)
+  std::shared_ptr<batch> caller_batch()
+  {
+    running* r = current_task();
+    if (r && r->pool == this) {
+      if (!r->children) {
+        r->children = std::make_shared<batch>();
+        r->children->parent = r->owner;
+      }
+      return r->children;
+    }
+    std::shared_ptr<batch>& b = _callers[std::this_thread::get_id()];
+    if (!b) b = std::make_shared<batch>();
+    return b;
+  }
+
+  // Ejecuta t sin _mtx tomado y lo descuenta de su lote y de los superiores,
+  // también si lanza (la excepción se guarda en esos lotes)
+  void run_task(task& t)
+  {
+    running r{this, t.owner, nullptr};
+    running* previous = current_task();
+    current_task() = &r;
+    std::exception_ptr error;
+    try {
+      t.fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    current_task() = previous;
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    bool finished = false;
+    for (batch* b = t.owner.get(); b; b = b->parent.get()) {
+      if (error && !b->error) b->error = error;
+      if (--b->pending == 0) finished = true;
+    }
+    if (finished) _done_cond.notify_all();
+  }
+
+  void worker_thread() {
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      _tids.push_back(static_cast<pid_t>(syscall(SYS_gettid)));
+    }
+    _done_cond.notify_all();
+    for (;;) {
+      task t;
+      {
+        std::unique_lock<std::mutex> lock(_mtx);
+        _work_cond.wait(lock, [this] { return _done || !_work_queue.empty(); });
+        if (_done && _work_queue.empty()) return;
+        t = std::move(_work_queue.front());
+        _work_queue.pop();
+      }
+      run_task(t);
+    }
+  }
+
+  public:
+  explicit thread_pool(std::size_t num_threads = default_threads())
+  {
+    if (num_threads == 0) num_threads = 1;
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      _threads.emplace_back(&thread_pool::worker_thread, this);
+    }
+  }
+
+  // Ids del kernel de los hilos del pool (espera a que hayan arrancado todos)
+  std::vector<pid_t> worker_tids()
+  {
+    std::unique_lock<std::mutex> lock(_mtx);
+    _done_cond.wait(lock, [this] { return _tids.size() == _threads.size(); });
+    return _tids;
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  ~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      _done = true;
+    }
+    _work_cond.notify_all();
+    for (auto& t : _threads) {
+      t.join();
+    }
+  }
+
+  static std::size_t default_threads()
+  {
+    std::size_t n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+  std::size_t size() const { return _threads.size(); }
+
+  // CPUs de la máscara de afinidad del hilo que llama (respeta taskset y
+  // cgroups), sin exclude_cpu salvo que sea la única. Hay que leerla antes de
+  // fijar ese hilo a una CPU: después la máscara ya solo contiene esa.
+  static std::vector<int> allowed_cpus(int exclude_cpu = -1)
+  {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set) && cpu != exclude_cpu) cpus.push_back(cpu);
+    }
+    if (cpus.empty() && exclude_cpu >= 0 && CPU_ISSET(exclude_cpu, &set)) cpus.push_back(exclude_cpu);
+    return cpus;
+  }
+
+  // Fija cada hilo del pool a una de las CPUs permitidas al hilo que llama
+  void pin_workers()
+  {
+    pin_workers(allowed_cpus());
+  }
+
+  // Fija el hilo i del pool a cpus[i % cpus.size()] (p.ej. las CPUs de un nodo NUMA)
+  void pin_workers(const std::vector<int>& cpus)
+  {
+    if (cpus.empty()) return;
+    for (std::size_t i = 0; i < _threads.size(); ++i) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpus[i % cpus.size()], &set);
+      pthread_setaffinity_np(_threads[i].native_handle(), sizeof(set), &set);
+    }
+  }
+
+  template<typename F>
+  void submit(F f)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      std::shared_ptr<batch> owner = caller_batch();
+      for (batch* b = owner.get(); b; b = b->parent.get()) ++b->pending;
+      _work_queue.push(task{std::function<void()>(std::move(f)), std::move(owner)});
+      if (_helpers > 0) _done_cond.notify_all();
+    }
+    _work_cond.notify_one();
+  }
+
+  // Espera a que terminen las tareas enviadas por este hilo (o, desde una
+  // tarea, por esta tarea), incluidas las que ellas hayan enviado
+  void wait()
+  {
+    std::unique_lock<std::mutex> lock(_mtx);
+    running* r = current_task();
+    if (r && r->pool == this) {
+      std::shared_ptr<batch> children = r->children;
+      if (!children) return;
+      while (children->pending > 0) {
+        if (_work_queue.empty()) {
+          ++_helpers;
+          _done_cond.wait(lock);
+          --_helpers;
+          continue;
+        }
+        task t = std::move(_work_queue.front());
+        _work_queue.pop();
+        lock.unlock();
+        run_task(t);
+        lock.lock();
+      }
+      std::exception_ptr error = std::move(children->error);
+      children->error = nullptr;
+      if (error) std::rethrow_exception(error);
+      return;
+    }
+    auto it = _callers.find(std::this_thread::get_id());
+    if (it == _callers.end()) return;
+    std::shared_ptr<batch> own = it->second;
+    _done_cond.wait(lock, [&own] { return own->pending == 0; });
+    _callers.erase(std::this_thread::get_id());
+    if (own->error) std::rethrow_exception(own->error);
+  }
+
+  // Pool compartido del proceso; se recrea solo si cambia el número de hilos.
+  // Recrearlo destruye el anterior: no puede haber otros hilos usándolo.
+  static thread_pool& shared(std::size_t num_threads = default_threads())
+  {
+    std::lock_guard<std::mutex> lock(instance_mutex());
+    std::unique_ptr<thread_pool>& pool = instance();
+    if (num_threads == 0) num_threads = default_threads();
+    if (!pool || pool->size() != num_threads) {
+      pool.reset(new thread_pool(num_threads));
+    }
+    return *pool;
+  }
+
+  // Pool compartido tal como esté (con su número de hilos y afinidad);
+  // solo lo crea si todavía no existe.
+  static thread_pool& current()
+  {
+    std::lock_guard<std::mutex> lock(instance_mutex());
+    std::unique_ptr<thread_pool>& pool = instance();
+    if (!pool) pool.reset(new thread_pool(default_threads()));
+    return *pool;
+  }
+
+  private:
+  static std::unique_ptr<thread_pool>& instance()
+  {
+    static std::unique_ptr<thread_pool> pool;
+    return pool;
+  }
+
+  static std::mutex& instance_mutex()
+  {
+    static std::mutex mtx;
+    return mtx;
+  }
+};
@@ -0,0 +1,464 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <linux/futex.h>
+#include <memory>
+#include <signal.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+/*
+    Transporte entre procesos para los algoritmos distribuidos (summa.hpp).
+
+    transport es la interfaz: envío y recepción punto a punto de bytes
+    (flujo ordenado por pareja de rangos, como un socket) y, encima, las
+    colectivas que necesita SUMMA (broadcast en árbol binomial dentro de un
+    grupo de rangos, barrera y reducción del máximo). Una implementación
+    nueva (TCP, MPI, ...) solo tiene que dar do_send y do_recv.
+
+    Implementaciones locales, para probar con varios procesos en una sola
+    máquina Linux:
+        shm     un segmento POSIX (shm_open + mmap) con un anillo por pareja
+                (origen, destino); quien espera duerme en un futex
+        socket  un socketpair de Unix por pareja de rangos
+
+    run_processes(p, kind, f) crea los recursos, lanza p - 1 procesos con
+    fork y ejecuta f(transport&) en todos; el proceso que llama es el rango 0.
+    Si un rango falla, los que esperan datos suyos (o de cualquier otro, en
+    shm) lanzan una excepción en vez de quedarse bloqueados: en socket el
+    otro extremo se cierra; en shm hay una marca de aborto en el segmento
+    que se revisa cada vez que un futex despierta o vence su espera.
+*/
+
+enum class transport_kind { shm, socket };
+
+inline transport_kind parse_transport(const std::string& name) {
+    if (name == "shm") return transport_kind::shm;
+    if (name == "socket") return transport_kind::socket;
+    throw std::runtime_error("Unknown transport: " + name + ".");
+}
+
+inline const char* transport_name(transport_kind kind) {
+    return kind == transport_kind::socket ? "socket" : "shm";
+}
+
+class transport
+{
+  std::size_t _rank, _size;
+  std::size_t _bytes_sent = 0;
+  double _comm_seconds = 0;
+
+  template <typename F>
+  void timed(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    _comm_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  protected:
+  virtual void do_send(std::size_t dest, const void* data, std::size_t bytes) = 0;
+  virtual void do_recv(std::size_t src, void* data, std::size_t bytes) = 0;
+
+  public:
+  transport(std::size_t rank, std::size_t size) : _rank(rank), _size(size) {}
+  virtual ~transport() = default;
+
+  transport(const transport&) = delete;
+  transport& operator=(const transport&) = delete;
+
+  std::size_t rank() const { return _rank; }
+  std::size_t size() const { return _size; }
+
+  // Bytes enviados y tiempo dentro de send/recv (incluye la espera al otro rango)
+  std::size_t bytes_sent() const { return _bytes_sent; }
+  double comm_seconds() const { return _comm_seconds; }
+  void reset_stats() {
+    _bytes_sent = 0;
+    _comm_seconds = 0;
+  }
+
+  void send(std::size_t dest, const void* data, std::size_t bytes) {
+    timed([&] { do_send(dest, data, bytes); });
+    _bytes_sent += bytes;
+  }
+
+  void recv(std::size_t src, void* data, std::size_t bytes) {
+    timed([&] { do_recv(src, data, bytes); });
+  }
+
+  /*
+      Broadcast en árbol binomial: group son los rangos que participan (el
+      mismo vector en todos) y root la posición del emisor dentro de group.
+      En el emisor data es la entrada; en los demás, la salida. Cada rango
+      recibe una vez de su padre y reenvía a sus hijos: log2(|group|) pasos.
+  */
+  void broadcast(void* data, std::size_t bytes, const std::vector<std::size_t>& group, std::size_t root) {
+    const std::size_t n = group.size();
+    const std::size_t me = std::find(group.begin(), group.end(), _rank) - group.begin();
+    if (me == n) throw std::runtime_error("Rank is not in the broadcast group.");
+    const std::size_t rel = (me + n - root) % n;
+
+    std::size_t mask = 1;
+    while (mask < n) {
+      if (rel & mask) {
+        recv(group[(rel - mask + root) % n], data, bytes);
+        break;
+      }
+      mask <<= 1;
+    }
+    for (mask >>= 1; mask > 0; mask >>= 1) {
+      if (rel + mask < n) send(group[(rel + mask + root) % n], data, bytes);
+    }
+  }
+
+  // Reduce value con op en el rango 0 y reparte el resultado a todos
+  template <typename Op>
+  double all_reduce(double value, Op op) {
+    if (_rank == 0) {
+      for (std::size_t r = 1; r < _size; r++) {
+        double v;
+        recv(r, &v, sizeof(v));
+        value = op(value, v);
+      }
+    } else {
+      send(0, &value, sizeof(value));
+    }
+    std::vector<std::size_t> all(_size);
+    for (std::size_t r = 0; r < _size; r++) all[r] = r;
+    broadcast(&value, sizeof(value), all, 0);
+    return value;
+  }
+
+  double max_all(double value) { return all_reduce(value, [](double x, double y) { return std::max(x, y); }); }
+  double sum_all(double value) { return all_reduce(value, [](double x, double y) { return x + y; }); }
+
+  void barrier() { max_all(0.0); }
+};
+
+// ------------------------------------------------------------------ shm
+
+/*
+    Anillo de un solo productor y un solo consumidor en memoria compartida.
+    head y tail cuentan bytes (módulo 2^32, capacidad potencia de 2): el
+    productor solo escribe head y el consumidor solo tail, y quien no puede
+    avanzar espera en un futex sobre el contador del otro.
+*/
+struct shm_ring {
+  alignas(64) std::atomic<std::uint32_t> head;
+  alignas(64) std::atomic<std::uint32_t> tail;
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "shm_ring needs lock-free 32-bit atomics");
+
+// Cabecera del segmento: rango que falló + 1 (0 mientras todo va bien)
+struct shm_control {
+  alignas(64) std::atomic<std::uint32_t> aborted;
+};
+
+// Espera como mucho timeout_ms a que word deje de valer expected
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected, long timeout_ms) {
+  timespec timeout;
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+inline void futex_wake(std::atomic<std::uint32_t>& word) {
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+class shm_transport : public transport
+{
+  public:
+  // Bytes por anillo (potencia de 2)
+  static constexpr std::size_t ring_bytes = std::size_t(1) << 18;
+  static constexpr std::size_t slot_bytes = sizeof(shm_ring) + ring_bytes;
+  // Cada cuánto se revisa la marca de aborto mientras se espera
+  static constexpr long poll_ms = 50;
+
+  // Crea y proyecta el segmento (cabecera + p * p anillos); lo heredan los
+  // procesos hijos con fork (el nombre se borra enseguida, no queda nada en
+  // /dev/shm)
+  static void* create_segment(std::size_t procs, std::size_t& length) {
+    length = sizeof(shm_control) + procs * procs * slot_bytes;
+    const std::string name = "/pacs_summa_" + std::to_string(getpid());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw std::runtime_error("shm_open failed: " + std::string(std::strerror(errno)) + ".");
+    shm_unlink(name.c_str());
+    if (ftruncate(fd, off_t(length)) != 0) {
+      close(fd);
+      throw std::runtime_error("ftruncate failed: " + std::string(std::strerror(errno)) + ".");
+    }
+    void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) throw std::runtime_error("mmap failed: " + std::string(std::strerror(errno)) + ".");
+    // ftruncate deja el segmento a cero: head = tail = 0 en todos los anillos
+    return base;
+  }
+
+  static shm_control& control(void* base) { return *static_cast<shm_control*>(base); }
+
+  // Marca el segmento como abortado por rank (se queda el primero que falla)
+  static void abort(void* base, std::size_t rank) {
+    std::uint32_t none = 0;
+    control(base).aborted.compare_exchange_strong(none, std::uint32_t(rank + 1));
+  }
+
+  // idle se llama cada vez que una espera vence sin datos (run_processes lo
+  // usa en el rango 0 para ver si algún hijo ha muerto)
+  shm_transport(std::size_t rank, std::size_t size, void* base, std::function<void()> idle = nullptr)
+      : transport(rank, size), _base(static_cast<char*>(base)), _idle(std::move(idle)) {}
+
+  private:
+  char* _base;
+  std::function<void()> _idle;
+
+  shm_ring& ring(std::size_t src, std::size_t dest) {
+    return *reinterpret_cast<shm_ring*>(_base + sizeof(shm_control) + (src * size() + dest) * slot_bytes);
+  }
+  char* ring_data(std::size_t src, std::size_t dest) {
+    return _base + sizeof(shm_control) + (src * size() + dest) * slot_bytes + sizeof(shm_ring);
+  }
+
+  void wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+    futex_wait(word, expected, poll_ms);
+    if (_idle && word.load(std::memory_order_acquire) == expected) _idle();
+    const std::uint32_t aborted = control(_base).aborted.load(std::memory_order_acquire);
+    if (aborted) throw std::runtime_error("Rank " + std::to_string(aborted - 1) + " failed.");
+  }
+
+  protected:
+  void do_send(std::size_t dest, const void* data, std::size_t bytes) override {
+    shm_ring& r = ring(rank(), dest);
+    char* buf = ring_data(rank(), dest);
+    const char* src = static_cast<const char*>(data);
+    while (bytes > 0) {
+      const std::uint32_t h = r.head.load(std::memory_order_relaxed);
+      const std::uint32_t t = r.tail.load(std::memory_order_acquire);
+      const std::size_t free = ring_bytes - std::uint32_t(h - t);
+      if (free == 0) {
+        wait(r.tail, t);
+        continue;
+      }
+      const std::size_t pos = h % ring_bytes;
+      const std::size_t chunk = std::min({bytes, free, ring_bytes - pos});
+      std::memcpy(buf + pos, src, chunk);
+      r.head.store(h + std::uint32_t(chunk), std::memory_order_release);
+      futex_wake(r.head);
+      src += chunk;
+      bytes -= chunk;
+    }
+  }
+
+  void do_recv(std::size_t src_rank, void* data, std::size_t bytes) override {
+    shm_ring& r = ring(src_rank, rank());
+    const char* buf = ring_data(src_rank, rank());
+    char* dst = static_cast<char*>(data);
+    while (bytes > 0) {
+      const std::uint32_t t = r.tail.load(std::memory_order_relaxed);
+      const std::uint32_t h = r.head.load(std::memory_order_acquire);
+      const std::size_t used = std::uint32_t(h - t);
+      if (used == 0) {
+        wait(r.head, h);
+        continue;
+      }
+      const std::size_t pos = t % ring_bytes;
+      const std::size_t chunk = std::min({bytes, used, ring_bytes - pos});
+      std::memcpy(dst, buf + pos, chunk);
+      r.tail.store(t + std::uint32_t(chunk), std::memory_order_release);
+      futex_wake(r.tail);
+      dst += chunk;
+      bytes -= chunk;
+    }
+  }
+};
+
+// --------------------------------------------------------------- socket
+
+class socket_transport : public transport
+{
+  std::vector<int> _fds;  // _fds[r]: extremo propio del socket con el rango r
+
+  protected:
+  void do_send(std::size_t dest, const void* data, std::size_t bytes) override {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+      ssize_t n = write(_fds[dest], p, bytes);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) throw std::runtime_error("Send to rank " + std::to_string(dest) + " failed.");
+      p += n;
+      bytes -= std::size_t(n);
+    }
+  }
+
+  void do_recv(std::size_t src, void* data, std::size_t bytes) override {
+    char* p = static_cast<char*>(data);
+    while (bytes > 0) {
+      ssize_t n = read(_fds[src], p, bytes);
+      if (n < 0 && errno == EINTR) continue;
+      if (n == 0) throw std::runtime_error("Connection closed by rank " + std::to_string(src) + ".");
+      if (n < 0) throw std::runtime_error("Receive from rank " + std::to_string(src) + " failed.");
+      p += n;
+      bytes -= std::size_t(n);
+    }
+  }
+
+  public:
+  // Un socketpair por pareja: fds[i * p + j] es el extremo de i hacia j
+  static std::vector<int> create_sockets(std::size_t procs) {
+    std::vector<int> fds(procs * procs, -1);
+    for (std::size_t i = 0; i < procs; i++) {
+      for (std::size_t j = i + 1; j < procs; j++) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+          for (int fd : fds) if (fd >= 0) close(fd);
+          throw std::runtime_error("socketpair failed: " + std::string(std::strerror(errno)) + ".");
+        }
+        fds[i * procs + j] = sv[0];
+        fds[j * procs + i] = sv[1];
+      }
+    }
+    return fds;
+  }
+
+  // Se queda con los extremos de rank y cierra los demás (así un rango que
+  // termina se ve como fin de fichero en los otros)
+  socket_transport(std::size_t rank, std::size_t size, const std::vector<int>& all) : transport(rank, size), _fds(size, -1) {
+    for (std::size_t i = 0; i < size; i++) {
+      for (std::size_t j = 0; j < size; j++) {
+        if (all[i * size + j] < 0) continue;
+        if (i == rank) _fds[j] = all[i * size + j];
+        else close(all[i * size + j]);
+      }
+    }
+  }
+
+  ~socket_transport() override {
+    for (int fd : _fds) if (fd >= 0) close(fd);
+  }
+};
+
+// ------------------------------------------------------------- procesos
+
+// Hijos de run_processes: pids[r - 1] es el rango r
+struct child_processes {
+  std::vector<pid_t> pids;
+  std::vector<bool> done;
+  std::size_t failed = 0;   // primer rango que ha fallado + 1 (0: ninguno)
+
+  // Recoge sin bloquearse los hijos que ya hayan terminado
+  void poll() {
+    for (std::size_t i = 0; i < pids.size(); i++) {
+      int status = 0;
+      if (done[i] || waitpid(pids[i], &status, WNOHANG) != pids[i]) continue;
+      done[i] = true;
+      if (!failed && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) failed = i + 2;
+    }
+  }
+
+  bool all_done() const { return std::find(done.begin(), done.end(), false) == done.end(); }
+
+  void kill_all() {
+    for (std::size_t i = 0; i < pids.size(); i++) {
+      if (!done[i]) kill(pids[i], SIGKILL);
+    }
+  }
+};
+
+/*
+    Ejecuta f(transport&) en procs procesos: el que llama es el rango 0 y
+    los rangos 1..procs-1 son hijos creados con fork, que terminan con
+    _exit al acabar f (sin destructores estáticos: el pool de hilos del
+    padre no existe en el hijo). Si algún rango falla, los que esperan sus
+    datos fallan a su vez (ver arriba), los hijos que queden se matan y se
+    lanza una excepción en el que llama.
+*/
+template <typename F>
+void run_processes(std::size_t procs, transport_kind kind, F f) {
+  procs = std::max<std::size_t>(1, procs);
+  void* segment = nullptr;
+  std::size_t length = 0;
+  std::vector<int> sockets;
+  if (kind == transport_kind::shm) segment = shm_transport::create_segment(procs, length);
+  else sockets = socket_transport::create_sockets(procs);
+
+  child_processes children;
+  // En shm, un hijo muerto sin avisar (una señal) se detecta aquí: el
+  // rango 0 mira sus hijos cada vez que una espera vence y marca el aborto
+  auto watch = [&] {
+    children.poll();
+    if (children.failed) shm_transport::abort(segment, children.failed - 1);
+  };
+  auto make = [&](std::size_t rank) -> std::unique_ptr<transport> {
+    if (kind == transport_kind::shm) {
+      std::function<void()> idle;
+      if (rank == 0) idle = watch;
+      return std::unique_ptr<transport>(new shm_transport(rank, procs, segment, idle));
+    }
+    return std::unique_ptr<transport>(new socket_transport(rank, procs, sockets));
+  };
+
+  std::cout.flush();
+  std::cerr.flush();
+  for (std::size_t rank = 1; rank < procs; rank++) {
+    pid_t pid = fork();
+    if (pid < 0) {
+      children.kill_all();
+      for (pid_t c : children.pids) waitpid(c, nullptr, 0);
+      if (segment) munmap(segment, length);
+      throw std::runtime_error("fork failed: " + std::string(std::strerror(errno)) + ".");
+    }
+    if (pid == 0) {
+      int code = 0;
+      try {
+        std::unique_ptr<transport> t = make(rank);
+        f(*t);
+      } catch (const std::exception& e) {
+        std::cerr << "rank " << rank << ": " << e.what() << std::endl;
+        if (segment) shm_transport::abort(segment, rank);
+        code = 1;
+      }
+      std::cout.flush();
+      _exit(code);
+    }
+    children.pids.push_back(pid);
+    children.done.push_back(false);
+  }
+
+  std::string error;
+  try {
+    std::unique_ptr<transport> t = make(0);
+    f(*t);
+  } catch (const std::exception& e) {
+    error = e.what();
+    children.kill_all();
+  }
+  // El transporte del rango 0 ya está cerrado (en socket, sus extremos);
+  // se recogen los hijos a medida que terminan para que el fallo de uno
+  // aborte a los que esperan datos suyos
+  for (;;) {
+    children.poll();
+    if (children.failed && segment) shm_transport::abort(segment, children.failed - 1);
+    if (children.all_done()) break;
+    usleep(1000);
+  }
+  if (error.empty() && children.failed) error = "Rank " + std::to_string(children.failed - 1) + " failed.";
+  if (segment) munmap(segment, length);
+  if (!error.empty()) throw std::runtime_error(error);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+/*
+    Perfil de ajuste de la máquina: fichero de texto clave=valor que escribe
+    executable/matrix_tune con la mejor configuración medida en este nodo,
+    p.ej.
+
+        double.kernel=avx512 8x16
+        double.mc=96
+        double.kc=256
+        double.algorithm=blocked
+        double.threads=4
+        double.tile=256
+
+    Se lee una sola vez, la primera vez que se consulta: al arrancar, cuando
+    se inicializan los valores por defecto de gemm_blocked (tamaños de
+    bloque), simd_micro_kernel, Matrix (algoritmo) y Matrix1D (hilos y
+    tile). Cada valor que falte en el perfil conserva su valor por defecto,
+    y se puede seguir cambiando después en el programa. El micro-kernel se
+    guarda por nombre ("avx512 8x16"): si la ISA activa es otra, se usa el
+    de por defecto de esa ISA. mc, kc y nc se midieron con ese micro-kernel
+    y solo se aplican cuando gemm_blocked usa ese mismo (gemm_blocking_for).
+
+    Ruta: la variable de entorno PACS_TUNING_PROFILE ("none" lo desactiva)
+    o, si no está definida, results/tuning_<hostname>.profile junto al
+    directorio del ejecutable (executable/../results, resuelto con
+    /proc/self/exe, no con el directorio actual), así varios nodos pueden
+    compartir el directorio con un perfil cada uno.
+*/
+
+using tuning_values = std::map<std::string, std::string>;
+
+inline std::string tuning_host_name() {
+    char host[256] = {};
+    if (gethostname(host, sizeof(host) - 1) != 0 || host[0] == '\0') return "localhost";
+    return host;
+}
+
+// Directorio results/ hermano del directorio del ejecutable; si no se puede
+// leer /proc/self/exe, results/ relativo al directorio actual
+inline std::string tuning_results_dir() {
+    char exe[4096];
+    ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (len <= 0) return "results";
+    std::string path(exe, std::size_t(len));
+    std::size_t slash = path.rfind('/');
+    if (slash == std::string::npos) return "results";
+    path.erase(slash);                  // directorio del ejecutable
+    slash = path.rfind('/');
+    path.erase(slash == std::string::npos ? 0 : slash);
+    return path + "/results";
+}
+
+inline std::string tuning_profile_path() {
+    const char* env = std::getenv("PACS_TUNING_PROFILE");
+    if (env) return env;
+    return tuning_results_dir() + "/tuning_" + tuning_host_name() + ".profile";
+}
+
+// Líneas clave=valor; se ignoran las vacías y las que empiezan por '#'
+inline tuning_values tuning_read(std::istream& in) {
+    tuning_values values;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            throw std::runtime_error("Invalid tuning profile line: " + line + ".");
+        }
+        values[line.substr(0, eq)] = line.substr(eq + 1);
+    }
+    return values;
+}
+
+inline void tuning_write(std::ostream& out, const tuning_values& values) {
+    for (const auto& kv : values) out << kv.first << "=" << kv.second << "\n";
+}
+
+// Perfil de este proceso (vacío si no hay fichero o está desactivado)
+inline const tuning_values& tuning_profile() {
+    static const tuning_values values = [] {
+        const std::string path = tuning_profile_path();
+        std::ifstream in(path);
+        if (path == "none" || !in) return tuning_values();
+        try {
+            return tuning_read(in);
+        } catch (const std::exception& e) {
+            std::cerr << path << ": " << e.what() << " Using default tuning." << std::endl;
+            return tuning_values();
+        }
+    }();
+    return values;
+}
+
+// Prefijo de las claves de cada tipo; los tipos sin nombre no se ajustan
+template <typename T>
+const char* tuning_type_name() { return nullptr; }
+template <>
+inline const char* tuning_type_name<double>() { return "double"; }
+template <>
+inline const char* tuning_type_name<float>() { return "float"; }
+
+// Valor de "<tipo>.<key>" en el perfil, o fallback
+template <typename T>
+std::string tuning_get(const std::string& key, const std::string& fallback) {
+    const char* type = tuning_type_name<T>();
+    if (!type) return fallback;
+    auto it = tuning_profile().find(std::string(type) + "." + key);
+    return it == tuning_profile().end() ? fallback : it->second;
+}
+
+template <typename T>
+std::size_t tuning_get_size(const std::string& key, std::size_t fallback) {
+    const std::string value = tuning_get<T>(key, "");
+    if (value.empty()) return fallback;
+    try {
+        return std::stoul(value);
+    } catch (const std::exception&) {
+        std::cerr << "Invalid tuning value " << key << "=" << value << ", using " << fallback << "." << std::endl;
+        return fallback;
+    }
+}
@@ -124,6 +124,38 @@ def compare_two_files(file1, file2):
     plt.grid(True)
     plt.show()
 
+def read_benchmark_csv(filename):
+    """Lee el CSV de ./executable/benchmark: {caso: {columna: [valores]}} ordenado por tamaño."""
+    import csv
+    cases = {}
+    with open(filename, 'r') as file:
+        for row in csv.DictReader(file):
+            case = cases.setdefault(row['name'], {})
+            for key, value in row.items():
+                if key != 'name':
+                    case.setdefault(key, []).append(float(value))
+    return cases
+
+def plot_benchmark(filename, metric='gflops'):
+    cases = read_benchmark_csv(filename)
+
+    plt.figure(figsize=(10, 6))
+
+    for name, data in cases.items():
+        if metric == 'median_s':
+            # Barras de error con el MAD
+            plt.errorbar(data['size'], data['median_s'], yerr=data['mad_s'], label=name, marker='o', capsize=3)
+        else:
+            plt.plot(data['size'], data[metric], label=name, marker='o')
+
+    plt.title(f'Benchmark: {metric}')
+    plt.xlabel('Tamaño de la Matriz (Size)')
+    plt.ylabel('GFLOP/s' if metric == 'gflops' else 'Tiempo (Segundos)')
+
+    plt.legend()
+    plt.grid(True)
+    plt.show()
+
 compare_two_files('results/time_matrix_2.txt', 'results/time_matrix.txt')
 exit()
 file_names = ['results/time_matrix.txt', 'results/time_matrix_2.txt', 'results/time_matrix_eg.txt']
@@ -0,0 +1,383 @@
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include "benchmark.hpp"
+#include "benchmark_eigen.hpp"
+#include "factorization.hpp"
+#include "matrix.hpp"
+#include "matrix_2.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/benchmark <size_inicial> <size_final> <incremento> [opciones]
+
+    opciones:
+        --cases=a,b,...      casos a medir (por defecto matrix,matrix2d,matrix1d_pool,eigen)
+        --csv=fichero        resultados en CSV (por defecto results/benchmark.csv)
+        --json=fichero       resultados también en JSON
+        --warmup=N           ejecuciones de calentamiento (2)
+        --min-reps=N         repeticiones mínimas (5)
+        --max-reps=N         repeticiones máximas (100)
+        --ci=X               semi-anchura relativa del IC95 objetivo (0.02)
+        --max-time=S         tiempo máximo por caso y tamaño en segundos (30)
+        --cpu=N              fija el hilo principal a la CPU N
+        --threads=N          hilos para matrix1d_pool/matrix1d_numa y eigen (por defecto todos)
+        --baseline=fichero   compara las medianas con una línea base y termina con
+                             código 1 si algún caso es más lento que el umbral
+        --threshold=P        regresión = mediana más de P % por encima de la base (10) y
+                             con IC95 que no se solapa con el de la base
+        --save-baseline=f    guarda los resultados como nueva línea base
+        --tag=T              etiqueta de la línea base guardada (p.ej. el commit)
+        --seed=N             semilla de las matrices aleatorias (1); todos los casos,
+                             Eigen incluido, miden las mismas entradas
+
+    Casos: matrix, matrix_naive, matrix_strassen, matrix_recursive, matrix_transpose,
+           matrix_transpose_in_place, matrix2d, matrix2d_ikj,
+           matrix2d_transposed, matrix2d_packed, matrix2d_transpose, matrix2d_pack,
+           matrix1d_async, matrix1d_pool, matrix1d_numa, eigen,
+           matrix_lu, matrix_cholesky, eigen_lu, eigen_llt
+
+    matrix_naive y matrix2d hacen el mismo bucle i-j-k (arreglo plano frente a
+    punteros a fila): su diferencia es el coste de la indirección. Las variantes
+    matrix2d_* cambian solo el recorrido de B; matrix2d_transpose y
+    matrix2d_pack miden aparte lo que cuesta preparar B.
+
+    matrix_lu / eigen_lu factorizan la misma clase de matriz (aleatoria) con
+    pivotaje parcial (lu_factor frente a Eigen::PartialPivLU), y
+    matrix_cholesky / eigen_llt una simétrica definida positiva; cada
+    repetición incluye copiar A, igual que hace compute() en Eigen.
+*/
+
+struct bench_case {
+    string name;
+    // Construye las entradas y la salida (fuera del cronómetro) y mide el producto
+    function<bench_result(unsigned size, double min_value, double max_value, const bench_options&)> run;
+};
+
+double gemm_flops(unsigned n) {
+    return 2.0 * n * n * n;
+}
+
+template <mult_algorithm Alg>
+bench_result bench_matrix(const string& name, unsigned n, double min_value, double max_value,
+                          const bench_options& opt) {
+    Matrix<double> a(n), b(n), c(n);
+    a.fill_random(min_value, max_value, opt.seed);
+    b.fill_random(min_value, max_value, opt.seed + 1);
+    mult_algorithm previous = Matrix<double>::algorithm;
+    Matrix<double>::algorithm = Alg;
+    bench_result r = run_benchmark(name, n, 1, gemm_flops(n), [&] { c = a * b; }, opt);
+    Matrix<double>::algorithm = previous;
+    return r;
+}
+
+// Traspuesta recursiva de Matrix<double> (sin FLOPs): a un destino nuevo o en sitio
+bench_result bench_matrix_transpose(bool in_place, const string& name, unsigned n, double min_value,
+                                    double max_value, const bench_options& opt) {
+    Matrix<double> a(n), t(n);
+    a.fill_random(min_value, max_value, opt.seed);
+    if (in_place) {
+        return run_benchmark(name, n, 1, 0, [&] { a.transpose_in_place(); }, opt);
+    }
+    return run_benchmark(name, n, 1, 0, [&] { t = transpose(a); }, opt);
+}
+
+// La traspuesta / los paneles de B se preparan fuera de la región medida;
+// su coste se mide aparte en matrix2d_transpose y matrix2d_pack.
+bench_result bench_matrix2d(matrix2d_variant variant, const string& name, unsigned n, double min_value,
+                            double max_value, const bench_options& opt) {
+    Matrix2D<double> a(n), b(n), c(n);
+    a.fill_random(min_value, max_value, opt.seed);
+    b.fill_random(min_value, max_value, opt.seed + 1);
+    switch (variant) {
+        case matrix2d_variant::ikj:
+            return run_benchmark(name, n, 1, gemm_flops(n), [&] { Matrix2D<double>::multiply_ikj(a, b, c); }, opt);
+        case matrix2d_variant::transposed_b: {
+            Matrix2D<double> bt = b.transposed();
+            return run_benchmark(name, n, 1, gemm_flops(n),
+                                 [&] { Matrix2D<double>::multiply_transposed(a, bt, c); }, opt);
+        }
+        case matrix2d_variant::packed_b: {
+            auto panels = Matrix2D<double>::pack_panels(b);
+            return run_benchmark(name, n, 1, gemm_flops(n),
+                                 [&] { Matrix2D<double>::multiply_packed(a, panels, c); }, opt);
+        }
+        default:
+            return run_benchmark(name, n, 1, gemm_flops(n), [&] { Matrix2D<double>::multiply_ijk(a, b, c); }, opt);
+    }
+}
+
+// Solo la preparación de B (sin FLOPs), sobre destinos reservados antes
+bench_result bench_matrix2d_prepare(matrix2d_variant variant, const string& name, unsigned n, double min_value,
+                                    double max_value, const bench_options& opt) {
+    Matrix2D<double> b(n), bt(n);
+    b.fill_random(min_value, max_value, opt.seed + 1);
+    if (variant == matrix2d_variant::transposed_b) {
+        return run_benchmark(name, n, 1, 0, [&] { b.transpose_into(bt); }, opt);
+    }
+    auto panels = Matrix2D<double>::pack_panels(b);
+    return run_benchmark(name, n, 1, 0, [&] { Matrix2D<double>::pack_panels(b, panels); }, opt);
+}
+
+bench_result bench_matrix1d(parallel_mode mode, const string& name, unsigned n, double min_value,
+                            double max_value, const bench_options& opt) {
+    // El modo se fija antes de rellenar: en modo numa la inicialización coloca las filas por nodo
+    Matrix1D<double>::mode = mode;
+    Matrix1D<double> a(n), b(n), c(n);
+    a.fill_random(min_value, max_value, opt.seed);
+    b.fill_random(min_value, max_value, opt.seed + 1);
+    unsigned threads = n;
+    if (mode == parallel_mode::pool_tiles) {
+        threads = thread_pool::shared(Matrix1D<double>::threads).size();
+    } else if (mode == parallel_mode::numa) {
+        threads = 0;
+        for (auto& pool : numa_pools(Matrix1D<double>::threads)) threads += pool->size();
+    }
+    return run_benchmark(name, n, threads, gemm_flops(n), [&] { Matrix1D<double>::multiply(a, b, c); }, opt);
+}
+
+bench_result bench_eigen(unsigned n, double min_value, double max_value, const bench_options& opt) {
+    Matrix<double> a(n), b(n);
+    a.fill_random(min_value, max_value, opt.seed);
+    b.fill_random(min_value, max_value, opt.seed + 1);
+    function<void()> product = eigen_gemm(n, a.data(), b.data());
+    return run_benchmark("eigen", n, eigen_threads(), gemm_flops(n), product, opt);
+}
+
+double lu_flops(unsigned n) {
+    return 2.0 / 3.0 * n * n * n;
+}
+
+bench_result bench_matrix_factor(bool cholesky, const string& name, unsigned n, double min_value,
+                                 double max_value, const bench_options& opt) {
+    Matrix<double> a(n), f(n);
+    a.fill_random(min_value, max_value, opt.seed);
+    const unsigned threads = thread_pool::current().size();
+    if (cholesky) {
+        make_spd(n, [&](unsigned i, unsigned j) -> double& { return a.data()[size_t(i) * n + j]; });
+        return run_benchmark(name, n, threads, lu_flops(n) / 2, [&] { f = a; cholesky_factor(f); }, opt);
+    }
+    vector<size_t> piv;
+    return run_benchmark(name, n, threads, lu_flops(n), [&] { f = a; piv = lu_factor(f); }, opt);
+}
+
+bench_result bench_eigen_factor(bool cholesky, const string& name, unsigned n, double min_value,
+                                double max_value, const bench_options& opt) {
+    Matrix<double> a(n);
+    a.fill_random(min_value, max_value, opt.seed);
+    if (cholesky) make_spd(n, [&](unsigned i, unsigned j) -> double& { return a.data()[size_t(i) * n + j]; });
+    function<void()> factor = eigen_factor(cholesky, n, a.data());
+    return run_benchmark(name, n, eigen_threads(), cholesky ? lu_flops(n) / 2 : lu_flops(n), factor, opt);
+}
+
+vector<bench_case> all_cases() {
+    return {
+        {"matrix", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix<mult_algorithm::blocked>("matrix", n, lo, hi, o); }},
+        {"matrix_naive", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix<mult_algorithm::naive>("matrix_naive", n, lo, hi, o); }},
+        {"matrix_strassen", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix<mult_algorithm::strassen>("matrix_strassen", n, lo, hi, o); }},
+        {"matrix_recursive", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix<mult_algorithm::recursive>("matrix_recursive", n, lo, hi, o); }},
+        {"matrix_transpose", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix_transpose(false, "matrix_transpose", n, lo, hi, o); }},
+        {"matrix_transpose_in_place", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix_transpose(true, "matrix_transpose_in_place", n, lo, hi, o); }},
+        {"matrix2d", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix2d(matrix2d_variant::ijk, "matrix2d", n, lo, hi, o); }},
+        {"matrix2d_ikj", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix2d(matrix2d_variant::ikj, "matrix2d_ikj", n, lo, hi, o); }},
+        {"matrix2d_transposed", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix2d(matrix2d_variant::transposed_b, "matrix2d_transposed", n, lo, hi, o); }},
+        {"matrix2d_packed", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix2d(matrix2d_variant::packed_b, "matrix2d_packed", n, lo, hi, o); }},
+        {"matrix2d_transpose", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix2d_prepare(matrix2d_variant::transposed_b, "matrix2d_transpose", n, lo, hi, o); }},
+        {"matrix2d_pack", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix2d_prepare(matrix2d_variant::packed_b, "matrix2d_pack", n, lo, hi, o); }},
+        {"matrix1d_async", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix1d(parallel_mode::async_rows, "matrix1d_async", n, lo, hi, o); }},
+        {"matrix1d_pool", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix1d(parallel_mode::pool_tiles, "matrix1d_pool", n, lo, hi, o); }},
+        {"matrix1d_numa", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix1d(parallel_mode::numa, "matrix1d_numa", n, lo, hi, o); }},
+        {"eigen", bench_eigen},
+        {"matrix_lu", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix_factor(false, "matrix_lu", n, lo, hi, o); }},
+        {"matrix_cholesky", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_matrix_factor(true, "matrix_cholesky", n, lo, hi, o); }},
+        {"eigen_lu", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_eigen_factor(false, "eigen_lu", n, lo, hi, o); }},
+        {"eigen_llt", [](unsigned n, double lo, double hi, const bench_options& o) {
+             return bench_eigen_factor(true, "eigen_llt", n, lo, hi, o); }},
+    };
+}
+
+// Compara con la línea base: 0 si no hay regresiones ni casos de la base sin
+// medir, 1 si los hay o no se puede leer
+int check_baseline(const string& file, const vector<bench_result>& results, double threshold) {
+    ifstream in(file);
+    if (!in) {
+        cerr << "No existe la línea base " << file << " (créala con --save-baseline)" << endl;
+        return 1;
+    }
+    baseline base;
+    try {
+        base = read_baseline(in);
+    } catch (const exception& e) {
+        cerr << "No se pudo leer la línea base " << file << ": " << e.what() << endl;
+        return 1;
+    }
+    if (base.cpu != cpu_model()) {
+        cerr << "Aviso: la línea base se midió en otra CPU (" << base.cpu << ")" << endl;
+    }
+
+    vector<bench_change> changes = compare_baseline(base, results, threshold);
+    size_t regressions = 0, missing = 0;
+    cout << "baseline " << file << " tag=" << base.tag << " threshold=" << threshold << "%" << endl;
+    for (const bench_change& c : changes) {
+        cout << c.name << " size=" << c.size << " threads=" << c.threads << " baseline=" << c.baseline_median << "s";
+        if (c.missing) {
+            cout << " MISSING" << endl;
+            missing++;
+            continue;
+        }
+        cout << " median=" << c.median << "s change=" << c.change_pct << "%"
+             << (c.regression ? " REGRESSION" : c.significant ? "" : " (ruido)") << endl;
+        regressions += c.regression;
+    }
+    size_t compared = changes.size() - missing;
+    if (compared < results.size()) {
+        cout << results.size() - compared << " casos sin línea base" << endl;
+    }
+    cout << regressions << " regresiones, " << missing << " casos de la línea base sin medir" << endl;
+    return regressions > 0 || missing > 0 ? 1 : 0;
+}
+
+vector<string> split(const string& s, char sep) {
+    vector<string> parts;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, sep)) {
+        if (!item.empty()) parts.push_back(item);
+    }
+    return parts;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Uso: " << argv[0] << " <size_inicial> <size_final> <incremento> [--cases=a,b,...]"
+             << " [--csv=fichero] [--json=fichero] [--warmup=N] [--min-reps=N] [--max-reps=N]"
+             << " [--ci=X] [--max-time=S] [--cpu=N] [--threads=N] [--baseline=fichero] [--threshold=P]"
+             << " [--save-baseline=fichero] [--tag=T] [--seed=N]" << endl;
+        return 1;
+    }
+
+    unsigned size_inicial = atoi(argv[1]);
+    unsigned size_final = atoi(argv[2]);
+    unsigned incremento = max(1, atoi(argv[3]));
+
+    bench_options opt;
+    vector<string> selected = {"matrix", "matrix2d", "matrix1d_pool", "eigen"};
+    string csv_file = "results/benchmark.csv", json_file;
+    string baseline_file, save_baseline_file, tag = "unknown";
+    double threshold = 10.0;
+    int cpu = -1;
+
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        string key = arg.substr(0, arg.find('='));
+        string value = arg.find('=') == string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (key == "--cases") selected = split(value, ',');
+        else if (key == "--csv") csv_file = value;
+        else if (key == "--json") json_file = value;
+        else if (key == "--warmup") opt.warmup = stoul(value);
+        else if (key == "--min-reps") opt.min_reps = stoul(value);
+        else if (key == "--max-reps") opt.max_reps = stoul(value);
+        else if (key == "--ci") opt.target_rel_ci = stod(value);
+        else if (key == "--max-time") opt.max_seconds = stod(value);
+        else if (key == "--cpu") cpu = stoi(value);
+        else if (key == "--threads") Matrix1D<double>::threads = stoul(value);
+        else if (key == "--baseline") baseline_file = value;
+        else if (key == "--threshold") threshold = stod(value);
+        else if (key == "--save-baseline") save_baseline_file = value;
+        else if (key == "--tag") tag = value;
+        else if (key == "--seed") opt.seed = stoull(value);
+        else {
+            cerr << "Opción desconocida: " << arg << endl;
+            return 1;
+        }
+    }
+
+    // Eigen con los mismos hilos que los productos paralelos propios. Su
+    // equipo de OpenMP se crea antes de fijar el hilo principal, para que no
+    // herede la CPU de --cpu y todos sus hilos acaben en un solo núcleo.
+    // Los hilos del pool se reparten entre las CPUs permitidas menos la de
+    // --cpu, leídas antes de que el hilo principal quede fijado.
+    vector<int> worker_cpus = thread_pool::allowed_cpus(cpu);
+    eigen_start(Matrix1D<double>::threads);
+    if (!pin_current_thread(cpu)) {
+        cerr << "No se pudo fijar el hilo a la CPU " << cpu << endl;
+    }
+    thread_pool::shared(Matrix1D<double>::threads).pin_workers(worker_cpus);
+
+    vector<bench_case> cases;
+    for (const string& name : selected) {
+        bool found = false;
+        for (const bench_case& c : all_cases()) {
+            if (c.name == name) {
+                cases.push_back(c);
+                found = true;
+            }
+        }
+        if (!found) {
+            cerr << "Caso desconocido: " << name << endl;
+            return 1;
+        }
+    }
+
+    vector<bench_result> results;
+    for (unsigned size = size_inicial; size <= size_final; size += incremento) {
+        for (const bench_case& c : cases) {
+            bench_result r = c.run(size, 1.0, 1000.0, opt);
+            cout << r.name << " size=" << r.size << " reps=" << r.reps << " median=" << r.median
+                 << "s p95=" << r.p95 << "s mad=" << r.mad << "s " << r.gflops << " GFLOP/s" << endl;
+            results.push_back(r);
+        }
+    }
+
+    ofstream csv(csv_file);
+    if (!csv) {
+        cerr << "Error opening file " << csv_file << endl;
+        return 1;
+    }
+    write_csv(csv, results);
+
+    if (!json_file.empty()) {
+        ofstream json(json_file);
+        write_json(json, results);
+    }
+
+    if (!save_baseline_file.empty()) {
+        ofstream out(save_baseline_file);
+        if (!out) {
+            cerr << "Error opening file " << save_baseline_file << endl;
+            return 1;
+        }
+        write_baseline(out, tag, results);
+    }
+
+    if (!baseline_file.empty()) {
+        return check_baseline(baseline_file, results, threshold);
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <memory>
+#include <omp.h>
+#include "../eigen-3.4.0/Eigen/Dense"
+#include "benchmark_eigen.hpp"
+
+/*
+    Casos de Eigen de benchmark (ver include/benchmark_eigen.hpp). Se enlaza
+    con benchmark.cpp; es la única parte compilada con EIGEN_FLAGS.
+*/
+
+void eigen_start(unsigned threads) {
+    if (threads > 0) Eigen::setNbThreads(int(threads));
+    // Una región paralela con todos los hilos crea ya el equipo de OpenMP
+    // (libgomp lo reutiliza en los productos de Eigen)
+    #pragma omp parallel num_threads(Eigen::nbThreads())
+    {
+    }
+}
+
+unsigned eigen_threads() {
+    return unsigned(Eigen::nbThreads());
+}
+
+// Copia de una matriz n x n guardada por filas (Eigen guarda por columnas)
+static Eigen::MatrixXd from_rows(unsigned n, const double* data) {
+    using row_major = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+    return Eigen::Map<const row_major>(data, n, n);
+}
+
+std::function<void()> eigen_gemm(unsigned n, const double* a, const double* b) {
+    struct state {
+        Eigen::MatrixXd a, b, c;
+    };
+    auto s = std::make_shared<state>();
+    s->a = from_rows(n, a);
+    s->b = from_rows(n, b);
+    s->c.resize(n, n);
+    return [s] { s->c.noalias() = s->a * s->b; };
+}
+
+std::function<void()> eigen_factor(bool cholesky, unsigned n, const double* a) {
+    struct state {
+        Eigen::MatrixXd a;
+        Eigen::PartialPivLU<Eigen::MatrixXd> lu;
+        Eigen::LLT<Eigen::MatrixXd> llt;
+    };
+    auto s = std::make_shared<state>();
+    s->a = from_rows(n, a);
+    if (cholesky) {
+        s->llt = Eigen::LLT<Eigen::MatrixXd>(n);
+        return [s] { s->llt.compute(s->a); };
+    }
+    s->lu = Eigen::PartialPivLU<Eigen::MatrixXd>(n);
+    return [s] { s->lu.compute(s->a); };
+}
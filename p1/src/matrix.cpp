@@ -2,82 +2,51 @@
 #include <vector>
 #include <random>
 #include <cstdlib>
+#include <cmath>
+#include <string>
+#include "matrix.hpp"
+#include "perf_counters.hpp"
 using namespace std;
 
 /*
-    g++ src/matrix.cpp -o executable/matrix
-    time ./executable/matrix
-
+    make
+    time ./executable/matrix <size> <min_value> <max_value> [naive|blocked|strassen|recursive] [opciones]
+
+    opciones:
+        --isa=scalar|avx2|avx512   fuerza la ISA de los kernels SIMD
+        --crossover=N              tamaño a partir del cual Strassen pasa al GEMM por bloques
+        --check                    compara el producto con el triple bucle en long double y muestra el error
+        --alloc=aligned|hugepage   almacenamiento alineado a 64 B o en huge pages de 2 MB
+        --perf                     contadores hardware (IPC, fallos de cache, FLOPs) de "init" y "multiply"
+        --seed=N                   semilla de las matrices aleatorias (A usa N y B N+1); sin ella
+                                   se toma una de random_device
 */
 
-
-template <typename T>
-class Matrix {
-    unsigned int _n;
-    T* m;
-
-public:
-
-    Matrix(unsigned int n) : _n(n), m(new T[n*n]) {}
-
-    Matrix(const vector<T>& v) {
-        _n = sqrt(v.size());
-        if (_n * _n != v.size()) {
-            throw runtime_error("Vector size must be a perfect square.");
-        }
-        m = new T[_n*_n];
-        fill(v);
-    }
-
-    ~Matrix() {
-        delete[] m;
-    }
-
-    // Función para llenar la matriz con números aleatorios de tipo double
-    void fill_random(T min_value = 1.0, T max_value = 100.0) {
-        random_device rd; 
-        mt19937 gen(rd()); 
-        uniform_real_distribution<T> dis(min_value, max_value); 
-
-        for (unsigned int i = 0; i < _n * _n; i++) {
-            m[i] = dis(gen); 
-        }
-    }
-
-    void fill(const vector<T>& v) {
-        if (_n * _n != v.size()) {
-            throw runtime_error("Vector and matrix size mismatch. Vector has size " + to_string(v.size()) + " and matrix has size " + to_string(_n * _n) + ".");
-        }
-        unsigned int k = 0;
-        for (unsigned int i = 0; i < _n * _n; i++) {
-            m[i] = v[k++];
-        }
-    }
-
-    friend Matrix operator*(const Matrix& a, const Matrix& b) {
-        if (a._n != b._n) {
-            throw runtime_error("Matrix size mismatch. Both matrices must have the same size.");
-        }
-
-        Matrix<T> c(a._n);
-        for (unsigned int i = 0; i < a._n; i++) {
-            for (unsigned int j = 0; j < a._n; j++) {
-                c.m[i*c._n+j] = 0;
-                for (unsigned int k = 0; k < a._n; k++) {
-                    c.m[i*c._n+j] += a.m[i*c._n+k] * b.m[k*c._n+j];
-                }
+// Error del producto calculado frente al triple bucle clásico acumulando en
+// long double (independiente de los kernels que se comparan, blocked incluido)
+template <typename T, typename Alloc>
+void accuracy_report(const Matrix<T, Alloc>& a, const Matrix<T, Alloc>& b, const Matrix<T, Alloc>& result) {
+    size_t n = a.rows(), m = a.cols(), p = b.cols();
+    vector<T> reference(n * p);
+    vector<long double> row(p);
+    for (size_t i = 0; i < n; i++) {
+        fill(row.begin(), row.end(), 0.0L);
+        for (size_t k = 0; k < m; k++) {
+            long double aik = a.data()[i * m + k];
+            const T* bk = b.data() + k * p;
+            for (size_t j = 0; j < p; j++) {
+                row[j] += aik * bk[j];
             }
         }
-        return c;
-    }
-
-    void print() const {
-        for (unsigned int i = 0; i < _n * _n; i++) {
-            cout << m[i] << " ";
-            if (i % _n == _n - 1) cout << endl;
+        for (size_t j = 0; j < p; j++) {
+            reference[i * p + j] = static_cast<T>(row[j]);
         }
     }
-};
+    product_error err = compare_products(n * p, result.data(), reference.data());
+    cout << "max_abs_error " << err.max_abs << "\n"
+         << "max_rel_error " << err.max_rel << "\n"
+         << "frobenius_rel_error " << err.frobenius << endl;
+}
 
 // Función de prueba para multiplicar matrices de tipo double
 void test_matrix() {
@@ -99,32 +68,89 @@ void test_matrix() {
     mat2.print();
     cout << "Resultado de la multiplicación de matrices:" << endl;
     result.print();
+
+    // Expresión encadenada: se evalúa sobre `chained` sin temporales intermedios
+    Matrix<double> chained = mat1 * mat2 + 2.0 * transpose(mat1);
+    gemm(0.5, mat2, mat2, 1.0, chained);
+    cout << "A*B + 2*A^T + 0.5*B*B:" << endl;
+    chained.print();
+
+    // Rectangulares y vistas: (2x1) * (1x2) con columnas/filas de las anteriores, sin copias
+    Matrix<double> outer = mat1.col_range(0, 1) * mat2.row_range(1, 2);
+    cout << "A(:, 0) * B(1, :):" << endl;
+    outer.print();
 }
 
 // Función para multiplicar matrices aleatorias de tipo double
-void multiplicar_matrix(unsigned int size, double min_value, double max_value) {
-    Matrix<double> mat1(size);
-    Matrix<double> mat2(size);
+// Con perf se imprimen los contadores hardware de las regiones "init" y "multiply"
+template <typename Alloc = aligned_allocator<double>>
+void multiplicar_matrix(unsigned int size, double min_value, double max_value, uint64_t seed,
+                        bool check = false, bool perf = false) {
+    perf_counters counters(perf ? perf_default_events() : vector<perf_event_spec>());
+    if (perf && !counters.available()) {
+        cerr << "perf_event_open no disponible (revisa /proc/sys/kernel/perf_event_paranoid)" << endl;
+    }
 
-    mat1.fill_random(min_value, max_value);
-    mat2.fill_random(min_value, max_value);
+    Matrix<double, Alloc> mat1(size);
+    Matrix<double, Alloc> mat2(size);
 
-    Matrix<double> result = mat1 * mat2;
+    counters.measure("init", [&] {
+        mat1.fill_random(min_value, max_value, seed);
+        mat2.fill_random(min_value, max_value, seed + 1);
+    });
+
+    Matrix<double, Alloc> result(size);
+    counters.measure("multiply", [&] { result = mat1 * mat2; });
+
+    if (perf) {
+        counters.report(cout);
+    }
 
+    if (check) {
+        accuracy_report(mat1, mat2, result);
+    }
     // result.print();
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value>" << endl;
+    if (argc < 4) {
+        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value> [naive|blocked|strassen|recursive]"
+             << " [--isa=scalar|avx2|avx512] [--crossover=N] [--check] [--alloc=aligned|hugepage] [--perf]"
+             << " [--seed=N]" << endl;
         return 1;
     }
 
     unsigned int size = atoi(argv[1]);
     double min_value = atof(argv[2]);  
     double max_value = atof(argv[3]);  
+    bool check = false;
+    bool huge_pages = false;
+    bool perf = false;
+    uint64_t seed = random_seed();
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--isa=", 0) == 0) {
+            simd_set_isa(parse_isa(arg.substr(6)));
+        } else if (arg.rfind("--crossover=", 0) == 0) {
+            Matrix<double>::strassen_crossover = stoul(arg.substr(12));
+        } else if (arg == "--check") {
+            check = true;
+        } else if (arg == "--perf") {
+            perf = true;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = stoull(arg.substr(7));
+        } else if (arg == "--alloc=hugepage" || arg == "--alloc=aligned") {
+            huge_pages = (arg == "--alloc=hugepage");
+        } else {
+            Matrix<double>::algorithm = parse_algorithm(arg);
+        }
+    }
 
-    multiplicar_matrix(size, min_value, max_value);
+    if (huge_pages) {
+        multiplicar_matrix<huge_page_allocator<double>>(size, min_value, max_value, seed, check, perf);
+    } else {
+        multiplicar_matrix(size, min_value, max_value, seed, check, perf);
+    }
 
     return 0;
 }
@@ -5,159 +5,79 @@
 #include <thread>
 #include <future>
 #include <cmath>
+#include <string>
+#include "matrix_2.hpp"
 
 using namespace std;
 
-// matriz con arreglo bidimensional
-template <typename T>
-class Matrix2D {
-    unsigned int _n;
-    T** m;
+/*
+    make
+    ./executable/2_matrix <size> <min_value> <max_value> <tipo> [hilos] [--order=ijk|ikj|transposed|packed] [--seed=N]
 
-public:
-    Matrix2D(unsigned int n) : _n(n) {
-        m = new T*[n];
-        for (unsigned int i = 0; i < n; i++) {
-            m[i] = new T[n];
-        }
-    }
-
-    ~Matrix2D() {
-        for (unsigned int i = 0; i < _n; i++) {
-            delete[] m[i];
-        }
-        delete[] m;
-    }
-
-    void fill_random(T min_value = 1.0, T max_value = 100.0) {
-        random_device rd; 
-        mt19937 gen(rd());
-        uniform_real_distribution<T> dis(min_value, max_value); 
-
-        for (unsigned int i = 0; i < _n; i++) {
-            for (unsigned int j = 0; j < _n; j++) {
-                m[i][j] = dis(gen); 
-            }
-        }
-    }
-
-    friend Matrix2D operator*(const Matrix2D& a, const Matrix2D& b) {
-        if (a._n != b._n) {
-            throw runtime_error("Matrix size mismatch.");
-        }
-
-        Matrix2D c(a._n);
-        for (unsigned int i = 0; i < a._n; i++) {
-            for (unsigned int j = 0; j < a._n; j++) {
-                c.m[i][j] = 0;
-                for (unsigned int k = 0; k < a._n; k++) {
-                    c.m[i][j] += a.m[i][k] * b.m[k][j];
-                }
-            }
-        }
-        return c;
-    }
-
-    void print() const {
-        for (unsigned int i = 0; i < _n; i++) {
-            for (unsigned int j = 0; j < _n; j++) {
-                cout << m[i][j] << " ";
-            }
-            cout << endl;
-        }
-    }
-};
-
-// matriz con arreglo unidimensional
-template <typename T>
-class Matrix1D {
-    unsigned int _n;
-    T* m;
+    tipo: 1 = Matrix2D (bucle elegido con --order; con transposed/packed se
+              imprime en stderr lo que tarda en preparar B)
+          2 = Matrix1D (un std::async por fila),
+          3 = Matrix1D (tiles 2D sobre un pool de hilos persistente)
+          4 = Matrix1D NUMA (inicialización y cálculo por nodo, hilos fijados,
+              réplica de B por nodo); imprime en stderr tiempo y GB/s de cada
+              nodo y fase
 
-public:
-    Matrix1D(unsigned int n) : _n(n), m(new T[n * n]) {}
-
-    ~Matrix1D() {
-        delete[] m;
-    }
-
-    void fill_random(T min_value = 1.0, T max_value = 100.0) {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_real_distribution<T> dis(min_value, max_value);
-
-        for (unsigned int i = 0; i < _n * _n; i++) {
-            m[i] = dis(gen);
-        }
-    }
-
-    friend Matrix1D operator*(const Matrix1D& a, const Matrix1D& b) {
-        if (a._n != b._n) {
-            throw runtime_error("Matrix size mismatch.");
-        }
-
-        Matrix1D c(a._n);
-        vector<future<void>> futures;
-
-        for (unsigned int i = 0; i < a._n; i++) {
-            futures.emplace_back(async(launch::async, [&, i] {
-                for (unsigned int j = 0; j < a._n; j++) {
-                    c.m[i * c._n + j] = 0;
-                    for (unsigned int k = 0; k < a._n; k++) {
-                        c.m[i * c._n + j] += a.m[i * a._n + k] * b.m[k * b._n + j];
-                    }
-                }
-            }));
-        }
-
-        for (auto& f : futures) {
-            f.get(); // Esperar a que todos los hilos terminen
-        }
-
-        return c;
-    }
-
-    void print() const {
-        for (unsigned int i = 0; i < _n * _n; i++) {
-            cout << m[i] << " ";
-            if (i % _n == _n - 1) cout << endl;
-        }
-    }
-};
+    --seed=N fija la semilla de las matrices aleatorias (A usa N y B N+1);
+    sin ella se toma una de random_device.
+*/
 
 // Función para multiplicar matrices aleatorias de tipo double
-void multiplicar_matrix(unsigned int size, double min_value, double max_value, int tipo) {
+void multiplicar_matrix(unsigned int size, double min_value, double max_value, int tipo, uint64_t seed) {
     if (tipo == 1) { // Matrices 2D
         Matrix2D<double> mat1(size);
         Matrix2D<double> mat2(size);
-        mat1.fill_random(min_value, max_value);
-        mat2.fill_random(min_value, max_value);
+        mat1.fill_random(min_value, max_value, seed);
+        mat2.fill_random(min_value, max_value, seed + 1);
         Matrix2D<double> result = mat1 * mat2;
         result.print();
-    } else if (tipo == 2) { // Matrices 1D
+        if (Matrix2D<double>::prepare_seconds > 0) {
+            cerr << "prepare_b_s " << Matrix2D<double>::prepare_seconds << endl;
+        }
+    } else if (tipo >= 2 && tipo <= 4) { // Matrices 1D
+        Matrix1D<double>::mode = (tipo == 4) ? parallel_mode::numa
+                               : (tipo == 3) ? parallel_mode::pool_tiles : parallel_mode::async_rows;
+        Matrix1D<double>::numa_record = true;
         Matrix1D<double> mat1(size);
         Matrix1D<double> mat2(size);
-        mat1.fill_random(min_value, max_value);
-        mat2.fill_random(min_value, max_value);
+        mat1.fill_random(min_value, max_value, seed);
+        mat2.fill_random(min_value, max_value, seed + 1);
         Matrix1D<double> result = mat1 * mat2;
         result.print();
+        numa_report(cerr, Matrix1D<double>::numa_stats);
     } else {
         cerr << "Tipo de matriz no válido." << endl;
     }
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 5) {
-        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value> <tipo>" << endl;
+    if (argc < 5 || argc > 8) {
+        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value> <tipo> [hilos]"
+             << " [--order=ijk|ikj|transposed|packed] [--seed=N]" << endl;
         return 1;
     }
 
     unsigned int size = atoi(argv[1]);
     double min_value = atof(argv[2]);  
     double max_value = atof(argv[3]);
-    int tipo = atoi(argv[4]); // 1 para 2D, 2 para 1D
+    int tipo = atoi(argv[4]); // 1 para 2D, 2 para 1D, 3 para 1D con pool, 4 para 1D NUMA
+    uint64_t seed = random_seed();
+    for (int i = 5; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--order=", 0) == 0) {
+            Matrix2D<double>::variant = parse_matrix2d_variant(arg.substr(8));
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = stoull(arg.substr(7));
+        } else {
+            Matrix1D<double>::threads = atoi(argv[i]);
+        }
+    }
 
-    multiplicar_matrix(size, min_value, max_value, tipo);
+    multiplicar_matrix(size, min_value, max_value, tipo, seed);
 
     return 0;
 }
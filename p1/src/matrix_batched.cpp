@@ -0,0 +1,116 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "matrix.hpp"
+#include "fixed_matrix.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_batched <size> <count> [--isa=scalar|avx2|avx512]
+
+    size     lado de las matrices (4, 8, 16 o 32)
+    count    número de productos del lote
+
+    Compara cuatro formas de hacer count productos size x size:
+        matrix       bucle de Matrix<double> (tamaño en tiempo de ejecución)
+        fixed        bucle de FixedMatrix<double, size> con operator*
+        strided      multiply_batched / gemm_batched_strided en una llamada
+        interleaved  gemm_batched_interleaved con los datos ya intercalados
+    e imprime el tiempo en segundos y los GFLOP/s de cada una.
+*/
+
+template <typename F>
+double time_seconds(F f) {
+    auto start = chrono::high_resolution_clock::now();
+    f();
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+void report(const string& name, size_t n, size_t count, double seconds) {
+    double gflops = 2.0 * n * n * n * count / seconds * 1e-9;
+    cout << name << " " << seconds << " s " << gflops << " GFLOP/s" << endl;
+}
+
+template <size_t N>
+void multiplicar_lote(size_t count) {
+    using fixed = FixedMatrix<double, N>;
+    vector<fixed> a(count), b(count), c(count);
+    for (size_t l = 0; l < count; l++) {
+        a[l].fill_random(1, 100, 2 * l);
+        b[l].fill_random(1, 100, 2 * l + 1);
+    }
+
+    vector<Matrix<double>> ma, mb;
+    for (size_t l = 0; l < count; l++) {
+        ma.emplace_back(static_cast<unsigned int>(N));
+        mb.emplace_back(static_cast<unsigned int>(N));
+        copy(a[l].data(), a[l].data() + N * N, ma[l].data());
+        copy(b[l].data(), b[l].data() + N * N, mb[l].data());
+    }
+    Matrix<double> mc(static_cast<unsigned int>(N));
+    report("matrix", N, count, time_seconds([&] {
+        for (size_t l = 0; l < count; l++) mc = ma[l] * mb[l];
+    }));
+
+    report("fixed", N, count, time_seconds([&] {
+        for (size_t l = 0; l < count; l++) c[l] = a[l] * b[l];
+    }));
+
+    report("strided", N, count, time_seconds([&] { multiply_batched(count, a.data(), b.data(), c.data()); }));
+
+    constexpr size_t W = batch_lanes<double>();
+    const size_t groups = (count + W - 1) / W;
+    vector<double> ia(groups * N * N * W), ib(groups * N * N * W), ic(groups * N * N * W);
+    batch_interleave<double, N, N>(count, a[0].data(), N * N, ia.data());
+    batch_interleave<double, N, N>(count, b[0].data(), N * N, ib.data());
+    report("interleaved", N, count, time_seconds([&] {
+        gemm_batched_interleaved<double, N, N, N>(groups, ia.data(), ib.data(), ic.data());
+    }));
+
+    // Los cuatro caminos deben dar el mismo resultado que el último producto de Matrix<double>
+    vector<double> last(N * N);
+    batch_deinterleave<double, N, N>(1, ic.data() + ((count - 1) / W) * N * N * W + (count - 1) % W, last.data(),
+                                     N * N);
+    double max_error = 0;
+    for (size_t e = 0; e < N * N; e++) {
+        max_error = max(max_error, abs(c[count - 1].data()[e] - mc.data()[e]));
+        max_error = max(max_error, abs(last[e] - mc.data()[e]));
+    }
+    cout << "max_abs_error " << max_error << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " <size:4|8|16|32> <count> [--isa=scalar|avx2|avx512]" << endl;
+        return 1;
+    }
+
+    unsigned int size = atoi(argv[1]);
+    size_t count = strtoul(argv[2], nullptr, 10);
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--isa=", 0) == 0) {
+            simd_set_isa(parse_isa(arg.substr(6)));
+        }
+    }
+    if (count == 0) {
+        cerr << "count debe ser mayor que 0" << endl;
+        return 1;
+    }
+
+    switch (size) {
+        case 4: multiplicar_lote<4>(count); break;
+        case 8: multiplicar_lote<8>(count); break;
+        case 16: multiplicar_lote<16>(count); break;
+        case 32: multiplicar_lote<32>(count); break;
+        default:
+            cerr << "size debe ser 4, 8, 16 o 32" << endl;
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "blas.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_blas <size> [--threads=N] [--isa=scalar|avx2|avx512] [--reps=R]
+
+    Mide dot, axpy y nrm2 sobre vectores de size * size doubles y gemv (normal
+    y traspuesta) y ger sobre una Matrix<double> de size x size, frente al
+    bucle escrito a mano que haría cada llamador. Por operación imprime el
+    mejor tiempo de R repeticiones (5 por defecto), el ancho de banda
+    efectivo (bytes mínimos que hay que leer/escribir) y el error frente a
+    una referencia en long double.
+*/
+
+template <typename F>
+double best_time(int reps, F f) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        auto start = chrono::high_resolution_clock::now();
+        f();
+        auto end = chrono::high_resolution_clock::now();
+        best = min(best, chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+void report(const string& op, double bytes, double blas_s, double loop_s, double blas_err, double loop_err) {
+    cout << "op=" << op << " time_s=" << blas_s << " gb_s=" << bytes / blas_s * 1e-9 << " loop_s=" << loop_s
+         << " loop_gb_s=" << bytes / loop_s * 1e-9 << " speedup=" << loop_s / blas_s << " error=" << blas_err
+         << " loop_error=" << loop_err << endl;
+}
+
+double max_diff(const vector<double>& a, const vector<long double>& ref) {
+    double err = 0;
+    for (size_t i = 0; i < a.size(); i++) err = max(err, double(fabsl(a[i] - ref[i])));
+    return err;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: " << argv[0] << " <size> [--threads=N] [--isa=scalar|avx2|avx512] [--reps=R]" << endl;
+        return 1;
+    }
+
+    size_t size = atoi(argv[1]);
+    int reps = 5;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--threads=", 0) == 0) {
+            thread_pool::shared(stoul(arg.substr(10)));
+        } else if (arg.rfind("--isa=", 0) == 0) {
+            simd_set_isa(parse_isa(arg.substr(6)));
+        } else if (arg.rfind("--reps=", 0) == 0) {
+            reps = stoi(arg.substr(7));
+        }
+    }
+    cout << "size=" << size << " threads=" << thread_pool::current().size()
+         << " isa=" << isa_name(simd_active_isa()) << endl;
+
+    const size_t n = size * size;
+    Matrix<double> a(size), xy(2, n);
+    a.fill_random(-1.0, 1.0, 1);
+    xy.fill_random(0.0, 1.0, 2);
+    vector<double> x(xy.data(), xy.data() + n), y(xy.data() + n, xy.data() + 2 * n);
+
+    // ---- dot
+    long double dot_ref = 0;
+    for (size_t i = 0; i < n; i++) dot_ref += (long double)x[i] * y[i];
+    double d_blas = 0, d_loop = 0;
+    double blas_s = best_time(reps, [&] { d_blas = dot(x, y); });
+    double loop_s = best_time(reps, [&] {
+        d_loop = 0;
+        for (size_t i = 0; i < n; i++) d_loop += x[i] * y[i];
+    });
+    report("dot", 16.0 * n, blas_s, loop_s, fabsl(d_blas - dot_ref), fabsl(d_loop - dot_ref));
+
+    // ---- axpy (se repite sobre el mismo z: el error se mide tras una sola llamada)
+    vector<double> z = y, z_loop = y;
+    vector<long double> axpy_ref(n);
+    for (size_t i = 0; i < n; i++) axpy_ref[i] = y[i] + 0.5L * x[i];
+    axpy(0.5, x, z);
+    for (size_t i = 0; i < n; i++) z_loop[i] += 0.5 * x[i];
+    double axpy_err = max_diff(z, axpy_ref), axpy_loop_err = max_diff(z_loop, axpy_ref);
+    blas_s = best_time(reps, [&] { axpy(0.5, x, z); });
+    loop_s = best_time(reps, [&] {
+        for (size_t i = 0; i < n; i++) z_loop[i] += 0.5 * x[i];
+    });
+    report("axpy", 24.0 * n, blas_s, loop_s, axpy_err, axpy_loop_err);
+
+    // ---- nrm2 (error relativo)
+    long double nrm_ref = 0;
+    for (size_t i = 0; i < n; i++) nrm_ref += (long double)x[i] * x[i];
+    nrm_ref = sqrtl(nrm_ref);
+    double nrm_blas = 0, nrm_loop = 0;
+    blas_s = best_time(reps, [&] { nrm_blas = nrm2(x); });
+    loop_s = best_time(reps, [&] {
+        double s = 0;
+        for (size_t i = 0; i < n; i++) s += x[i] * x[i];
+        nrm_loop = sqrt(s);
+    });
+    report("nrm2", 8.0 * n, blas_s, loop_s, fabsl(nrm_blas - nrm_ref) / nrm_ref,
+           fabsl(nrm_loop - nrm_ref) / nrm_ref);
+
+    // ---- gemv y gemv traspuesta
+    vector<double> v(x.begin(), x.begin() + size), w(size, 0.0), w_loop(size, 0.0);
+    vector<long double> gemv_ref(size, 0.0L), gemvt_ref(size, 0.0L);
+    for (size_t i = 0; i < size; i++) {
+        for (size_t j = 0; j < size; j++) {
+            gemv_ref[i] += (long double)a.data()[i * size + j] * v[j];
+            gemvt_ref[j] += (long double)a.data()[i * size + j] * v[i];
+        }
+    }
+    blas_s = best_time(reps, [&] { gemv(1.0, a, v, 0.0, w); });
+    double gemv_err = max_diff(w, gemv_ref);
+    loop_s = best_time(reps, [&] {
+        for (size_t i = 0; i < size; i++) {
+            double s = 0;
+            for (size_t j = 0; j < size; j++) s += a.data()[i * size + j] * v[j];
+            w_loop[i] = s;
+        }
+    });
+    report("gemv", 8.0 * n, blas_s, loop_s, gemv_err, max_diff(w_loop, gemv_ref));
+
+    blas_s = best_time(reps, [&] { gemv(1.0, a, v, 0.0, w, true); });
+    gemv_err = max_diff(w, gemvt_ref);
+    loop_s = best_time(reps, [&] {
+        fill(w_loop.begin(), w_loop.end(), 0.0);
+        for (size_t i = 0; i < size; i++)
+            for (size_t j = 0; j < size; j++) w_loop[j] += a.data()[i * size + j] * v[i];
+    });
+    report("gemv_t", 8.0 * n, blas_s, loop_s, gemv_err, max_diff(w_loop, gemvt_ref));
+
+    // ---- ger (cada repetición vuelve a sumar x * y^T sobre la misma matriz)
+    Matrix<double> g = a, g_loop = a;
+    vector<double> u(y.begin(), y.begin() + size);
+    blas_s = best_time(reps, [&] { ger(1.0, v, u, g); });
+    loop_s = best_time(reps, [&] {
+        for (size_t i = 0; i < size; i++)
+            for (size_t j = 0; j < size; j++) g_loop.data()[i * size + j] += v[i] * u[j];
+    });
+    double ger_diff = 0;
+    for (size_t i = 0; i < n; i++) ger_diff = max(ger_diff, fabs(g.data()[i] - g_loop.data()[i]));
+    report("ger", 16.0 * n, blas_s, loop_s, ger_diff, 0.0);
+
+    return 0;
+}
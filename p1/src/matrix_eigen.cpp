@@ -1,31 +1,52 @@
 #include <iostream>
+#include <chrono>
+#include <string>
 #include "../eigen-3.4.0/Eigen/Dense"  
-#include <random>
+#include "../include/random_fill.hpp"
 #include <cstdlib>
 
 using namespace std;
 using namespace Eigen;
 
-// Función para generar matrices aleatorias 
-MatrixXd generate_random_matrix(unsigned int size, double min_value, double max_value) {
-    MatrixXd mat(size, size);
-    
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_real_distribution<> dis(min_value, max_value);  
-    
-    for (int i = 0; i < mat.size(); ++i) {
-        mat(i) = dis(gen);
-    }
+/*
+    make
+    ./executable/eigen_matrix <size> <min_value> <max_value> [opciones]
+
+    opciones:
+        --threads=N          hilos del GEMM de Eigen (OpenMP; por defecto todos los núcleos)
+        --cache=L1,L2,L3     tamaños de caché en KB con los que Eigen elige sus bloques
+        --time               imprime el tiempo de la multiplicación y los GFLOP/s
+        --seed=N             semilla de las matrices aleatorias (A usa N y B N+1); sin ella
+                             se toma una de random_device
 
+    El Makefile compila este binario con -fopenmp -march=native (EIGEN_FLAGS),
+    así Eigen usa su GEMM paralelo y la ISA de la máquina.
+*/
+
+// Función para generar matrices aleatorias (Philox en paralelo, ver random_fill.hpp)
+MatrixXd generate_random_matrix(unsigned int size, double min_value, double max_value,
+                                uint64_t seed = random_seed()) {
+    MatrixXd mat(size, size);
+    random_fill(mat.data(), mat.size(), min_value, max_value, seed);
     return mat;
 }
 
 // Función para multiplicar matrices 
-void multiplicar_matrix(unsigned int size, double min_value, double max_value, bool verbose=false) {
-    MatrixXd mat1 = generate_random_matrix(size, min_value, max_value);
-    MatrixXd mat2 = generate_random_matrix(size, min_value, max_value);
-    MatrixXd result = mat1 * mat2;
+void multiplicar_matrix(unsigned int size, double min_value, double max_value, uint64_t seed,
+                        bool verbose=false, bool timing=false) {
+    MatrixXd mat1 = generate_random_matrix(size, min_value, max_value, seed);
+    MatrixXd mat2 = generate_random_matrix(size, min_value, max_value, seed + 1);
+    MatrixXd result(size, size);
+
+    // noalias: el producto se escribe directamente en result, sin temporal
+    auto start = chrono::steady_clock::now();
+    result.noalias() = mat1 * mat2;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (timing) {
+        cout << "threads=" << Eigen::nbThreads() << " multiply_s=" << seconds
+             << " gflops=" << 2.0 * size * size * size / seconds * 1e-9 << endl;
+    }
 
     if (verbose){
         cout << "Matrix 1:\n" << mat1 << endl;
@@ -35,16 +56,41 @@ void multiplicar_matrix(unsigned int size, double min_value, double max_value, b
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value>" << endl;
+    if (argc < 4) {
+        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value> [--threads=N] [--cache=L1,L2,L3] [--time]"
+             << " [--seed=N]" << endl;
         return 1;
     }
 
     unsigned int size = atoi(argv[1]);
     double min_value = atof(argv[2]);  
     double max_value = atof(argv[3]);  
+    bool timing = false;
+    uint64_t seed = random_seed();
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--threads=", 0) == 0) {
+            Eigen::setNbThreads(stoi(arg.substr(10)));
+        } else if (arg.rfind("--cache=", 0) == 0) {
+            string sizes = arg.substr(8);
+            size_t c1 = sizes.find(','), c2 = sizes.find(',', c1 + 1);
+            if (c1 == string::npos || c2 == string::npos) {
+                cerr << "--cache espera L1,L2,L3 en KB" << endl;
+                return 1;
+            }
+            Eigen::setCpuCacheSizes(stol(sizes.substr(0, c1)) * 1024, stol(sizes.substr(c1 + 1, c2 - c1 - 1)) * 1024,
+                                    stol(sizes.substr(c2 + 1)) * 1024);
+        } else if (arg == "--time") {
+            timing = true;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = stoull(arg.substr(7));
+        } else {
+            cerr << "Opción desconocida: " << arg << endl;
+            return 1;
+        }
+    }
 
-    multiplicar_matrix(size, min_value, max_value);
+    multiplicar_matrix(size, min_value, max_value, seed, false, timing);
 
     return 0;
 }
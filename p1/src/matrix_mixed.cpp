@@ -0,0 +1,122 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <cstdlib>
+#include "matrix.hpp"
+#include "mixed_precision.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_mixed <size> <min_value> <max_value> [modos] [--isa=scalar|avx2|avx512]
+
+    modos: lista separada por comas de f64, f32, bf16, int8 (por defecto todos)
+
+    Multiplica las mismas matrices (generadas en double) en cada precisión y
+    compara el resultado con el producto en double. Por modo imprime:
+        bytes     bytes por elemento de A y B
+        convert_s tiempo de pasar A y B al tipo de almacenamiento
+        time_s    tiempo del producto (con int8 incluye reescalar C)
+        gflops    2 n^3 / time_s
+        max_abs_error, max_rel_error, frobenius_rel_error frente a double
+*/
+
+template <typename F>
+double time_seconds(F f) {
+    auto start = chrono::high_resolution_clock::now();
+    f();
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+// Producto en el modo pedido, devuelto en double para compararlo
+vector<double> multiply_mode(precision_mode mode, unsigned int n, const Matrix<double>& a, const Matrix<double>& b,
+                             double& convert_s, double& time_s) {
+    const size_t count = size_t(n) * n;
+    vector<double> result(count);
+
+    if (mode == precision_mode::f32) {
+        Matrix<float> af(n), bf(n), cf(n);
+        convert_s = time_seconds([&] {
+            copy(a.data(), a.data() + count, af.data());
+            copy(b.data(), b.data() + count, bf.data());
+        });
+        time_s = time_seconds([&] { cf = af * bf; });
+        copy(cf.data(), cf.data() + count, result.begin());
+    } else if (mode == precision_mode::bf16) {
+        vector<bfloat16, aligned_allocator<bfloat16>> ab(count), bb(count);
+        Matrix<float> cf(n);
+        convert_s = time_seconds([&] {
+            to_bfloat16(count, a.data(), ab.data());
+            to_bfloat16(count, b.data(), bb.data());
+        });
+        time_s = time_seconds([&] { gemm_bf16(n, n, n, ab.data(), n, bb.data(), n, cf.data(), n); });
+        copy(cf.data(), cf.data() + count, result.begin());
+    } else if (mode == precision_mode::int8) {
+        vector<int8_t, aligned_allocator<int8_t>> aq(count), bq(count);
+        vector<int32_t, aligned_allocator<int32_t>> ci(count);
+        float scale_a = 1, scale_b = 1;
+        convert_s = time_seconds([&] {
+            scale_a = quantize_int8(count, a.data(), aq.data());
+            scale_b = quantize_int8(count, b.data(), bq.data());
+        });
+        time_s = time_seconds([&] {
+            gemm_int8(n, n, n, aq.data(), n, bq.data(), n, ci.data(), n);
+            const double scale = double(scale_a) * scale_b;
+            for (size_t i = 0; i < count; i++) result[i] = scale * ci[i];
+        });
+    } else {
+        Matrix<double> c(n);
+        convert_s = 0;
+        time_s = time_seconds([&] { c = a * b; });
+        copy(c.data(), c.data() + count, result.begin());
+    }
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value> [f64,f32,bf16,int8]"
+             << " [--isa=scalar|avx2|avx512]" << endl;
+        return 1;
+    }
+
+    unsigned int size = atoi(argv[1]);
+    double min_value = atof(argv[2]);
+    double max_value = atof(argv[3]);
+    vector<precision_mode> modes = {precision_mode::f64, precision_mode::f32, precision_mode::bf16,
+                                    precision_mode::int8};
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--isa=", 0) == 0) {
+            simd_set_isa(parse_isa(arg.substr(6)));
+        } else {
+            modes.clear();
+            stringstream ss(arg);
+            string name;
+            while (getline(ss, name, ',')) modes.push_back(parse_precision(name));
+        }
+    }
+
+    Matrix<double> a(size), b(size), reference(size);
+    a.fill_random(min_value, max_value);
+    b.fill_random(min_value, max_value);
+    reference = a * b;
+
+    const size_t count = size_t(size) * size;
+    for (precision_mode mode : modes) {
+        double convert_s = 0, time_s = 0;
+        vector<double> c = multiply_mode(mode, size, a, b, convert_s, time_s);
+        product_error err = compare_products(count, c.data(), reference.data());
+        cout << "mode=" << precision_name(mode) << " bytes=" << precision_bytes(mode)
+             << " convert_s=" << convert_s << " time_s=" << time_s
+             << " gflops=" << 2.0 * size * size * size / time_s * 1e-9
+             << " max_abs_error=" << err.max_abs << " max_rel_error=" << err.max_rel
+             << " frobenius_rel_error=" << err.frobenius << endl;
+    }
+
+    return 0;
+}
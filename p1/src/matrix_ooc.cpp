@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include "matrix_file.hpp"
+#include "random_fill.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_ooc random <fichero> <size> <tile> <min_value> <max_value> [--seed=N]
+    ./executable/matrix_ooc multiply <A> <B> <C> <presupuesto_MB>
+    ./executable/matrix_ooc check <A> <B> <C>
+
+    random   genera una matriz aleatoria en disco, tile a tile (no necesita caber en RAM).
+             El elemento (i, j) es el i * size + j de la secuencia Philox de la
+             semilla, como fill_random de Matrix: con la misma --seed el fichero
+             es idéntico sea cual sea el tile. Sin --seed se toma una de random_device.
+    multiply C = A * B fuera de memoria; imprime el tiempo de la multiplicación en segundos.
+             Si los tiles de A y B no caben en el presupuesto (ver
+             out_of_core_min_budget) se rechaza antes de crear C.
+    check    carga las tres matrices en RAM y compara C con el producto en memoria
+*/
+
+void generate_random_file(const string& path, unsigned long size, unsigned long tile,
+                          double min_value, double max_value, uint64_t seed) {
+    auto m = mapped_matrix<double>::create(path, size, size, tile, tile);
+
+    for (uint64_t ti = 0; ti < m.tile_count_rows(); ti++) {
+        for (uint64_t tj = 0; tj < m.tile_count_cols(); tj++) {
+            double* t = m.tile(ti, tj);
+            for (size_t i = 0; i < m.tile_height(ti); i++) {
+                uint64_t first = (ti * tile + i) * size + tj * tile;
+                philox::uniform(seed, first, m.tile_width(tj), min_value, max_value - min_value, t + i * tile);
+            }
+            m.release_tile(ti, tj);
+        }
+    }
+}
+
+void multiply_files(const string& a_path, const string& b_path, const string& c_path, size_t budget_mb) {
+    auto a = mapped_matrix<double>::open(a_path);
+    auto b = mapped_matrix<double>::open(b_path);
+    const size_t budget = budget_mb << 20, needed = out_of_core_min_budget(a, b);
+    if (budget_mb > (SIZE_MAX >> 20) || budget < needed) {
+        throw runtime_error("A memory budget of " + to_string(budget_mb) + " MB cannot hold the tiles of '" + a_path +
+                           "' and '" + b_path + "': at least " + to_string((needed + (1 << 20) - 1) >> 20) +
+                           " MB are needed (or regenerate them with smaller tiles).");
+    }
+    auto c = mapped_matrix<double>::create(c_path, a.rows(), b.cols(), a.tile_rows(), b.tile_cols());
+
+    auto start = chrono::steady_clock::now();
+    out_of_core_multiply(a, b, c, budget);
+    auto end = chrono::steady_clock::now();
+
+    cout << chrono::duration<double>(end - start).count() << endl;
+}
+
+void check_files(const string& a_path, const string& b_path, const string& c_path) {
+    Matrix<double> a = mapped_matrix<double>::open(a_path).load();
+    Matrix<double> b = mapped_matrix<double>::open(b_path).load();
+    Matrix<double> c = mapped_matrix<double>::open(c_path).load();
+    Matrix<double> reference = a * b;
+
+    product_error err = compare_products(c.count(), c.data(), reference.data());
+    cout << "max_abs_error " << err.max_abs << "\n"
+         << "max_rel_error " << err.max_rel << endl;
+}
+
+void usage(const char* name) {
+    cerr << "Uso: " << name << " random <fichero> <size> <tile> <min_value> <max_value> [--seed=N]\n"
+         << "     " << name << " multiply <A> <B> <C> <presupuesto_MB>\n"
+         << "     " << name << " check <A> <B> <C>" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string cmd = (argc > 1) ? argv[1] : "";
+
+    try {
+        if (cmd == "random" && (argc == 7 || (argc == 8 && string(argv[7]).rfind("--seed=", 0) == 0))) {
+            uint64_t seed = argc == 8 ? stoull(string(argv[7]).substr(7)) : random_seed();
+            generate_random_file(argv[2], stoul(argv[3]), stoul(argv[4]), atof(argv[5]), atof(argv[6]), seed);
+        } else if (cmd == "multiply" && argc == 6) {
+            multiply_files(argv[2], argv[3], argv[4], stoul(argv[5]));
+        } else if (cmd == "check" && argc == 5) {
+            check_files(argv[2], argv[3], argv[4]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "factorization.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_solve <size> [--threads=N] [--block=B] [--rhs=R] [--isa=scalar|avx2|avx512]
+
+    Resuelve A X = B (A: size x size aleatoria, B: size x R, R = 1 por
+    defecto) con lu_factor + lu_solve y, sobre una A simétrica definida
+    positiva, con cholesky_factor + cholesky_solve. Por método imprime el
+    tiempo de la factorización y de la resolución, los GFLOP/s de la
+    factorización (2/3 n^3 la LU, 1/3 n^3 Cholesky) y el residuo relativo
+        max |A X - B| / (max |A| * max |X| * n)
+    que debe quedar cerca del epsilon de la máquina.
+*/
+
+template <typename F>
+double time_seconds(F f) {
+    auto start = chrono::high_resolution_clock::now();
+    f();
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+double max_abs(const Matrix<double>& m) {
+    double r = 0;
+    for (size_t i = 0; i < m.count(); i++) r = max(r, fabs(m.data()[i]));
+    return r;
+}
+
+double relative_residual(const Matrix<double>& a, const Matrix<double>& x, const Matrix<double>& b) {
+    Matrix<double> ax = a * x;
+    double r = 0;
+    for (size_t i = 0; i < b.count(); i++) r = max(r, fabs(ax.data()[i] - b.data()[i]));
+    return r / (max_abs(a) * max_abs(x) * a.rows());
+}
+
+void report(const string& method, double flops, double factor_s, double solve_s, double residual) {
+    cout << "method=" << method << " factor_s=" << factor_s << " gflops=" << flops / factor_s * 1e-9
+         << " solve_s=" << solve_s << " residual=" << residual << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: " << argv[0] << " <size> [--threads=N] [--block=B] [--rhs=R] [--isa=scalar|avx2|avx512]"
+             << endl;
+        return 1;
+    }
+
+    size_t size = atoi(argv[1]);
+    size_t block = factor_block, rhs = 1;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--threads=", 0) == 0) {
+            thread_pool::shared(stoul(arg.substr(10)));
+        } else if (arg.rfind("--block=", 0) == 0) {
+            block = stoul(arg.substr(8));
+        } else if (arg.rfind("--rhs=", 0) == 0) {
+            rhs = stoul(arg.substr(6));
+        } else if (arg.rfind("--isa=", 0) == 0) {
+            simd_set_isa(parse_isa(arg.substr(6)));
+        }
+    }
+    cout << "size=" << size << " rhs=" << rhs << " block=" << block << " threads=" << thread_pool::current().size()
+         << " isa=" << isa_name(simd_active_isa()) << endl;
+
+    const double n = size;
+    Matrix<double> a(size, size), b(size, rhs);
+    a.fill_random(-1.0, 1.0, 1);
+    b.fill_random(-1.0, 1.0, 2);
+
+    // ---- LU con pivotaje parcial
+    Matrix<double> lu = a, x = b;
+    vector<size_t> piv;
+    double factor_s = time_seconds([&] { piv = lu_factor(lu, block); });
+    double solve_s = time_seconds([&] { lu_solve(lu, piv, x); });
+    report("lu", 2.0 / 3.0 * n * n * n, factor_s, solve_s, relative_residual(a, x, b));
+
+    // ---- Cholesky sobre S = (A + A^T) / 2 con diagonal dominante
+    Matrix<double> s(size, size);
+    for (size_t i = 0; i < size; i++) {
+        double row = 0;
+        for (size_t j = 0; j < size; j++) {
+            s.data()[i * size + j] = 0.5 * (a.data()[i * size + j] + a.data()[j * size + i]);
+            if (j != i) row += fabs(s.data()[i * size + j]);
+        }
+        s.data()[i * size + i] = row + 1.0;
+    }
+    Matrix<double> l = s;
+    x = b;
+    factor_s = time_seconds([&] { cholesky_factor(l, block); });
+    solve_s = time_seconds([&] { cholesky_solve(l, x); });
+    report("cholesky", n * n * n / 3.0, factor_s, solve_s, relative_residual(s, x, b));
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "sparse_matrix.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_sparse <size> <densidad> [--block=B] [--threads=N]
+
+    Genera una matriz size x size con una fracción `densidad` de elementos no
+    nulos (Philox, misma semilla -> misma matriz), la convierte a CSR, CSC y
+    BSR (bloques B x B, por defecto 4) y mide, para cada formato y para el
+    producto denso:
+        spmv   y = A * x
+        spmm   C = A * B con B densa de size x size
+    Imprime nnz, tiempos y el error máximo frente al producto denso.
+*/
+
+template <typename F>
+double time_seconds(F f) {
+    auto start = chrono::high_resolution_clock::now();
+    f();
+    auto end = chrono::high_resolution_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+double max_error(size_t count, const double* c, const double* ref) {
+    double err = 0;
+    for (size_t i = 0; i < count; i++) err = max(err, fabs(c[i] - ref[i]));
+    return err;
+}
+
+template <class Sparse>
+void run_format(const string& name, const Sparse& a, const Matrix<double>& b, const vector<double>& x,
+                const Matrix<double>& c_ref, const vector<double>& y_ref, double convert_s) {
+    vector<double> y;
+    double spmv_s = time_seconds([&] { y = a * x; });
+    Matrix<double> c(a.rows(), b.cols());
+    double spmm_s = time_seconds([&] { a.multiply(b, c); });
+    cout << name << " convert_s=" << convert_s << " spmv_s=" << spmv_s << " spmm_s=" << spmm_s
+         << " spmv_error=" << max_error(y.size(), y.data(), y_ref.data())
+         << " spmm_error=" << max_error(c.count(), c.data(), c_ref.data()) << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " <size> <densidad> [--block=B] [--threads=N]" << endl;
+        return 1;
+    }
+
+    unsigned int size = atoi(argv[1]);
+    double density = atof(argv[2]);
+    size_t block = 4;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--block=", 0) == 0) {
+            block = stoul(arg.substr(8));
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            thread_pool::shared(stoul(arg.substr(10)));
+        }
+    }
+
+    // A dispersa: los elementos cuyo "dado" supera la densidad se ponen a cero
+    Matrix<double> a(size), mask(size), b(size);
+    a.fill_random(-1.0, 1.0, 1);
+    mask.fill_random(0.0, 1.0, 2);
+    b.fill_random(-1.0, 1.0, 3);
+    for (size_t i = 0; i < a.count(); i++) {
+        if (mask.data()[i] >= density) a.data()[i] = 0.0;
+    }
+    vector<double> x(b.data(), b.data() + size);
+
+    Matrix<double> c_ref(size);
+    double dense_s = time_seconds([&] { c_ref = a * b; });
+    vector<double> y_ref(size, 0.0);
+    double dense_mv_s = time_seconds([&] {
+        for (size_t i = 0; i < size; i++) {
+            double sum = 0;
+            for (size_t j = 0; j < size; j++) sum += a.data()[i * size + j] * x[j];
+            y_ref[i] = sum;
+        }
+    });
+    cout << "dense spmv_s=" << dense_mv_s << " spmm_s=" << dense_s << endl;
+
+    csr_matrix<double> csr;
+    double csr_s = time_seconds([&] { csr = csr_matrix<double>::from_dense(a); });
+    cout << "nnz=" << csr.nnz() << " density=" << csr.density() << endl;
+    run_format("csr", csr, b, x, c_ref, y_ref, csr_s);
+
+    csc_matrix<double> csc;
+    double csc_s = time_seconds([&] { csc = csc_matrix<double>::from_dense(a); });
+    run_format("csc", csc, b, x, c_ref, y_ref, csc_s);
+
+    bsr_matrix<double> bsr;
+    double bsr_s = time_seconds([&] { bsr = bsr_matrix<double>::from_dense(a, block); });
+    cout << "bsr blocks=" << bsr.blocks() << " stored=" << bsr.stored() << endl;
+    run_format("bsr", bsr, b, x, c_ref, y_ref, bsr_s);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "matrix.hpp"
+#include "summa.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_summa <size> [--procs=1,2,4] [--transport=shm|socket] [--block=B] [--check]
+
+    Producto distribuido SUMMA (summa.hpp) con 1, 2, 4, ... procesos en
+    esta máquina. Para cada número de procesos p mide:
+        strong   size x size fijo: speedup = t(1) / t(p)
+        weak     size * sqrt(p): la misma memoria por proceso
+    En las dos, eficiencia = gflops(p) / (p * gflops(1)), el rendimiento por
+    proceso respecto al de uno solo (en weak el trabajo por proceso crece con
+    sqrt(p), así que no vale comparar tiempos). Muestra también la malla
+    pr x pc, el tiempo del producto (entre barreras), el tiempo máximo de
+    comunicación de un rango y los GB enviados entre todos.
+    --check compara cada resultado con el producto en un solo proceso.
+*/
+
+vector<size_t> parse_list(const string& s) {
+    vector<size_t> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(stoul(item));
+    }
+    return out;
+}
+
+struct scaling_point {
+    double multiply_s = 0, gflops = 0;
+};
+
+scaling_point run(const string& scaling, size_t procs, size_t size, transport_kind kind, size_t block, bool check,
+                  const scaling_point& base) {
+    Matrix<double> a(size, size), b(size, size);
+    a.fill_random(-1.0, 1.0, 1);
+    b.fill_random(-1.0, 1.0, 2);
+
+    summa_stats st;
+    Matrix<double> c = distributed_multiply(a, b, procs, kind, block, &st);
+    const double n = size;
+    scaling_point point;
+    point.multiply_s = st.multiply_s;
+    point.gflops = 2.0 * n * n * n / st.multiply_s * 1e-9;
+
+    const double speedup = base.multiply_s > 0 ? base.multiply_s / point.multiply_s : 1.0;
+    double efficiency = 1.0;
+    if (base.gflops > 0) efficiency = point.gflops / (procs * base.gflops);
+
+    cout << "scaling=" << scaling << " procs=" << procs << " grid=" << st.grid_rows << "x" << st.grid_cols
+         << " size=" << size << " multiply_s=" << st.multiply_s << " gflops=" << point.gflops;
+    if (scaling == "strong") cout << " speedup=" << speedup;
+    cout << " efficiency=" << efficiency << " comm_s=" << st.comm_s << " comm_gb=" << st.bytes * 1e-9
+         << " distribute_s=" << st.distribute_s << " collect_s=" << st.collect_s;
+    if (check) {
+        Matrix<double> ref(size, size);
+        Matrix<double>::multiply_blocked(a, b, ref);
+        cout << " error=" << compare_products(ref.count(), c.data(), ref.data()).max_rel;
+    }
+    cout << endl;
+    return point;
+}
+
+void usage(const char* name) {
+    cerr << "Uso: " << name << " <size> [--procs=1,2,4] [--transport=shm|socket] [--block=B] [--check]" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    size_t size = atoi(argv[1]);
+    vector<size_t> procs = {1, 2, 4};
+    transport_kind kind = transport_kind::shm;
+    size_t block = summa_block;
+    bool check = false;
+    try {
+        for (int i = 2; i < argc; i++) {
+            string arg = argv[i];
+            if (arg.rfind("--procs=", 0) == 0) {
+                procs = parse_list(arg.substr(8));
+            } else if (arg.rfind("--transport=", 0) == 0) {
+                kind = parse_transport(arg.substr(12));
+            } else if (arg.rfind("--block=", 0) == 0) {
+                block = stoul(arg.substr(8));
+            } else if (arg == "--check") {
+                check = true;
+            } else {
+                throw runtime_error("Unknown option: " + arg + ".");
+            }
+        }
+        if (size == 0 || procs.empty() || block == 0) {
+            throw runtime_error("Size, processes and block must be positive.");
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        usage(argv[0]);
+        return 1;
+    }
+    cout << "size=" << size << " transport=" << transport_name(kind) << " block=" << block
+         << " isa=" << isa_name(simd_active_isa()) << endl;
+
+    // La referencia de las dos escalas es el primer número de procesos de la lista
+    try {
+        scaling_point base;
+        for (size_t p : procs) {
+            scaling_point point = run("strong", p, size, kind, block, check, base);
+            if (base.multiply_s == 0) base = point;
+        }
+        base = scaling_point();
+        for (size_t p : procs) {
+            size_t weak_size = size_t(size * sqrt(double(p) / procs.front()) + 0.5);
+            scaling_point point = run("weak", p, weak_size, kind, block, check, base);
+            if (base.multiply_s == 0) base = point;
+        }
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <limits>
+#include "benchmark.hpp"
+#include "matrix.hpp"
+#include "matrix_2.hpp"
+#include "tuning_profile.hpp"
+
+using namespace std;
+
+/*
+    make
+    ./executable/matrix_tune [size] [opciones]
+
+    opciones:
+        --types=double,float   tipos a ajustar (por defecto los dos)
+        --threads=1,2,4        hilos a probar en Matrix1D (por defecto 1, 2, 4, ... hasta todas las CPUs)
+        --isa=avx2|avx512      ISA para la que se ajusta (por defecto la mejor de la CPU)
+        --strassen             incluye Strassen entre los órdenes de recorrido (cambia el redondeo)
+        --max-time=S           tiempo máximo por configuración medida (1 s)
+        --out=fichero          perfil a escribir (por defecto el que se carga al arrancar)
+
+    Autoajuste de los productos en este nodo, sobre matrices size x size
+    (768 por defecto). Cada etapa mide con el mismo arnés que benchmark y
+    fija lo mejor antes de pasar a la siguiente:
+        kernel     forma del micro-kernel (variantes de la ISA activa)
+        blocking   kc (panel de B en L1) x mc (panel de A en L2)
+        order      recorrido de Matrix<T>: GEMM por bloques o recursivo
+                   (cache-oblivious), y Strassen con --strassen
+        threads    hilos y lado del tile de Matrix1D en modo pool
+    El perfil (tuning_profile.hpp) se escribe conservando las claves de
+    otros tipos que ya tuviera, y Matrix, Matrix1D y gemm_blocked lo cargan
+    al arrancar.
+*/
+
+struct tune_options {
+    size_t size = 768;
+    vector<string> types = {"double", "float"};
+    vector<size_t> threads;
+    bool strassen = false;
+    bench_options bench;
+};
+
+vector<string> split(const string& s, char sep) {
+    vector<string> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, sep)) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+void report_trial(const string& type, const string& stage, const string& config, const bench_result& r) {
+    cout << "type=" << type << " stage=" << stage << " config=\"" << config << "\" median=" << r.median
+         << "s gflops=" << r.gflops << endl;
+}
+
+template <typename T>
+void tune_type(const tune_options& opt, tuning_values& profile) {
+    const string type = tuning_type_name<T>();
+    const size_t n = opt.size;
+    const double flops = 2.0 * n * n * n;
+
+    // Se parte de los valores por defecto, no del perfil que se haya cargado;
+    // mientras se ajusta, los tamaños valen para cualquier micro-kernel
+    gemm_tuned_blocking<T>() = gemm_blocking();
+    gemm_tuned_blocking_kernel<T>().clear();
+    Matrix<T>::algorithm = mult_algorithm::blocked;
+
+    Matrix<T> a(n), b(n), c(n), reference(n);
+    a.fill_random(T(-1), T(1), 1);
+    b.fill_random(T(-1), T(1), 2);
+    Matrix<T>::multiply_blocked(a, b, reference);
+    // Umbral de error relativo para descartar una variante: muy por encima
+    // del redondeo normal de un producto de tamaño n
+    const double tolerance = 1e3 * n * numeric_limits<T>::epsilon();
+
+    // ---- forma del micro-kernel
+    micro_kernel<T> best_kernel = simd_micro_kernel<T>();
+    double best = 0;
+    for (const micro_kernel<T>& k : simd_micro_kernels<T>(simd_active_isa())) {
+        simd_set_micro_kernel(k);
+        bench_result r = run_benchmark("kernel", n, 1, flops, [&] { Matrix<T>::multiply_blocked(a, b, c); }, opt.bench);
+        report_trial(type, "kernel", k.name, r);
+        if (compare_products(c.count(), c.data(), reference.data()).max_rel > tolerance) {
+            cerr << "Discarding micro-kernel " << k.name << ": wrong result." << endl;
+            continue;
+        }
+        if (r.gflops > best) {
+            best = r.gflops;
+            best_kernel = k;
+        }
+    }
+    simd_set_micro_kernel(best_kernel);
+
+    // ---- kc (L1) x mc (L2), mc en múltiplos de mr
+    gemm_blocking best_blocking;
+    best = 0;
+    for (size_t kc : {128, 192, 256, 320, 384, 512}) {
+        vector<size_t> mcs;
+        for (size_t target : {48, 72, 96, 144, 192, 288}) {
+            size_t mc = max(best_kernel.mr, (target + best_kernel.mr / 2) / best_kernel.mr * best_kernel.mr);
+            if (mcs.empty() || mcs.back() != mc) mcs.push_back(mc);
+        }
+        for (size_t mc : mcs) {
+            gemm_blocking bs;
+            bs.mc = mc;
+            bs.kc = kc;
+            gemm_tuned_blocking<T>() = bs;
+            bench_result r = run_benchmark("blocking", n, 1, flops, [&] { Matrix<T>::multiply_blocked(a, b, c); },
+                                           opt.bench);
+            report_trial(type, "blocking", "mc=" + to_string(mc) + " kc=" + to_string(kc), r);
+            if (r.gflops > best) {
+                best = r.gflops;
+                best_blocking = bs;
+            }
+        }
+    }
+    gemm_tuned_blocking<T>() = best_blocking;
+    gemm_tuned_blocking_kernel<T>() = best_kernel.name;
+
+    // ---- orden de recorrido de Matrix<T>
+    vector<pair<mult_algorithm, unsigned>> orders = {{mult_algorithm::blocked, 0}, {mult_algorithm::recursive, 0}};
+    if (opt.strassen) {
+        for (unsigned crossover : {128u, 256u, 512u}) orders.push_back({mult_algorithm::strassen, crossover});
+    }
+    pair<mult_algorithm, unsigned> best_order = orders[0];
+    double best_order_gflops = 0;
+    for (const auto& order : orders) {
+        Matrix<T>::algorithm = order.first;
+        if (order.second) Matrix<T>::strassen_crossover = order.second;
+        bench_result r = run_benchmark("order", n, 1, flops, [&] { c = a * b; }, opt.bench);
+        string config = algorithm_name(order.first);
+        if (order.second) config += " crossover=" + to_string(order.second);
+        report_trial(type, "order", config, r);
+        if (r.gflops > best_order_gflops) {
+            best_order_gflops = r.gflops;
+            best_order = order;
+        }
+    }
+    Matrix<T>::algorithm = best_order.first;
+    if (best_order.second) Matrix<T>::strassen_crossover = best_order.second;
+
+    // ---- hilos y tile de Matrix1D (modo pool)
+    Matrix1D<T>::mode = parallel_mode::pool_tiles;
+    Matrix1D<T> a1(n), b1(n), c1(n);   // c1 fuera de la región medida
+    a1.fill_random(T(-1), T(1), 1);
+    b1.fill_random(T(-1), T(1), 2);
+    size_t best_threads = 1;
+    unsigned best_tile = Matrix1D<T>::tile;
+    double best_pool = 0;
+    for (size_t threads : opt.threads) {
+        for (unsigned tile : {128u, 192u, 256u, 384u, 512u}) {
+            Matrix1D<T>::threads = threads;
+            Matrix1D<T>::tile = tile;
+            bench_result r = run_benchmark("threads", n, threads, flops, [&] { Matrix1D<T>::multiply(a1, b1, c1); }, opt.bench);
+            report_trial(type, "threads", "threads=" + to_string(threads) + " tile=" + to_string(tile), r);
+            if (r.gflops > best_pool) {
+                best_pool = r.gflops;
+                best_threads = threads;
+                best_tile = tile;
+            }
+        }
+    }
+    Matrix1D<T>::threads = best_threads;
+    Matrix1D<T>::tile = best_tile;
+
+    cout << "best type=" << type << " kernel=\"" << best_kernel.name << "\" mc=" << best_blocking.mc
+         << " kc=" << best_blocking.kc << " algorithm=" << algorithm_name(best_order.first)
+         << " gflops=" << best_order_gflops << " threads=" << best_threads << " tile=" << best_tile
+         << " pool_gflops=" << best_pool << endl;
+
+    profile[type + ".kernel"] = best_kernel.name;
+    profile[type + ".mc"] = to_string(best_blocking.mc);
+    profile[type + ".kc"] = to_string(best_blocking.kc);
+    profile[type + ".nc"] = to_string(best_blocking.nc);
+    profile[type + ".algorithm"] = algorithm_name(best_order.first);
+    if (best_order.second) {
+        profile[type + ".strassen_crossover"] = to_string(best_order.second);
+    } else {
+        profile.erase(type + ".strassen_crossover");
+    }
+    profile[type + ".threads"] = to_string(best_threads);
+    profile[type + ".tile"] = to_string(best_tile);
+    profile[type + ".gflops"] = to_string(best_order_gflops);
+    profile[type + ".pool_gflops"] = to_string(best_pool);
+}
+
+int main(int argc, char* argv[]) {
+    tune_options opt;
+    opt.bench.warmup = 1;
+    opt.bench.min_reps = 3;
+    opt.bench.max_reps = 20;
+    opt.bench.target_rel_ci = 0.03;
+    opt.bench.max_seconds = 1.0;
+    string out = tuning_profile_path();
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string key = arg.substr(0, arg.find('='));
+        string value = arg.find('=') == string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (arg[0] != '-') opt.size = stoul(arg);
+        else if (key == "--types") opt.types = split(value, ',');
+        else if (key == "--threads") {
+            for (const string& t : split(value, ',')) opt.threads.push_back(stoul(t));
+        } else if (key == "--isa") simd_set_isa(parse_isa(value));
+        else if (key == "--strassen") opt.strassen = true;
+        else if (key == "--max-time") opt.bench.max_seconds = stod(value);
+        else if (key == "--out") out = value;
+        else {
+            cerr << "Uso: " << argv[0] << " [size] [--types=double,float] [--threads=1,2,4]"
+                 << " [--isa=scalar|avx2|avx512] [--strassen] [--max-time=S] [--out=fichero]" << endl;
+            return 1;
+        }
+    }
+    if (opt.threads.empty()) {
+        const size_t hw = thread_pool::default_threads();
+        for (size_t t = 1; t < hw; t *= 2) opt.threads.push_back(t);
+        opt.threads.push_back(hw);
+    }
+    if (out == "none") {
+        cerr << "PACS_TUNING_PROFILE=none: use --out to choose where to write the profile." << endl;
+        return 1;
+    }
+
+    // Se conservan las claves de otros tipos que ya tuviera el perfil
+    tuning_values profile;
+    {
+        ifstream in(out);
+        if (in) profile = tuning_read(in);
+    }
+    profile["host"] = tuning_host_name();
+    profile["isa"] = isa_name(simd_active_isa());
+    profile["size"] = to_string(opt.size);
+    cout << "host=" << profile["host"] << " isa=" << profile["isa"] << " size=" << opt.size << endl;
+
+    for (const string& type : opt.types) {
+        if (type == "double") tune_type<double>(opt, profile);
+        else if (type == "float") tune_type<float>(opt, profile);
+        else throw runtime_error("Unknown type: " + type + ".");
+    }
+
+    ofstream file(out);
+    if (!file) {
+        cerr << "Error opening file " << out << endl;
+        return 1;
+    }
+    file << "# Perfil de ajuste generado por matrix_tune (ver include/tuning_profile.hpp)\n";
+    tuning_write(file, profile);
+    cout << "profile=" << out << endl;
+    return 0;
+}
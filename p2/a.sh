@@ -25,8 +25,8 @@ size_final=$4
 incremento=$5
 
 echo "Compilando ficheros..."
-g++ src/matrix.cpp -o $FOLDER_EXE/matrix
-g++ -O2 -Wall -I p2/eigen-3.4.0/ src/matrix_eigen.cpp -o $FOLDER_EXE/eigen_matrix
+g++ -I ../p1/include src/matrix.cpp -o $FOLDER_EXE/matrix
+g++ -O2 -Wall -I p2/eigen-3.4.0/ -I ../p1/include src/matrix_eigen.cpp -o $FOLDER_EXE/eigen_matrix
 
 
 # Archivos para guardar los tiempos de ejecución
@@ -26,8 +26,8 @@ N=$3
 num_repeticiones=$4
 
 echo "Compiling files..."
-g++ src/matrix.cpp -o $FOLDER_EXE/matrix
-g++ -O2 -Wall -I p2/eigen-3.4.0/ src/matrix_eigen.cpp -o $FOLDER_EXE/eigen_matrix
+g++ -I ../p1/include src/matrix.cpp -o $FOLDER_EXE/matrix
+g++ -O2 -Wall -I p2/eigen-3.4.0/ -I ../p1/include src/matrix_eigen.cpp -o $FOLDER_EXE/eigen_matrix
 
 
 output_file="$FOLDER_RESULT_MY_MATRIX/ex3_strace_matrix.txt"
@@ -9,10 +9,11 @@
 # ....
 # <time_init_matrix_num_repeticiones>
 # <time_multiplication_matrix_num_repeticiones>
-# % time     seconds  usecs/call     calls    errors syscall
-# 
-# Performance counter stats for './executable/eigen_matrix 1500 1 10000' (10 runs):
-#            545,97 msec task-clock                       #    0,997 CPUs utilized               ( +-  0,68% )
+# perf init time_s=... cycles=... instructions=... ipc=... l1d_miss_rate=... llc_miss_rate=... gflops=...
+# perf multiply time_s=... cycles=... instructions=... ipc=... l1d_miss_rate=... llc_miss_rate=... gflops=...
+#
+# Los contadores los lee cada ejecutable con perf_event_open (--perf), separados
+# por fase, así que no hace falta `sudo perf stat` alrededor del proceso.
 
 FOLDER_EXE="executable"
 FOLDER_RESULT="results"
@@ -32,8 +33,8 @@ N=$3
 num_repeticiones=$4
 
 echo "Compiling files..."
-g++ src/matrix.cpp -o $FOLDER_EXE/matrix
-g++ -O2 -Wall -I p2/eigen-3.4.0/ src/matrix_eigen.cpp -o $FOLDER_EXE/eigen_matrix
+g++ -I ../p1/include src/matrix.cpp -o $FOLDER_EXE/matrix
+g++ -O2 -Wall -I p2/eigen-3.4.0/ -I ../p1/include src/matrix_eigen.cpp -o $FOLDER_EXE/eigen_matrix
 
 
 output_file="$FOLDER_RESULT_MY_MATRIX/ex4_perf_matrix.txt"
@@ -46,7 +47,10 @@ echo "Running..."
 
 # (strace -c ./$FOLDER_EXE/matrix $N $min_value $max_value >> $output_file) 2>> $output_file
 # (strace -c ./$FOLDER_EXE/eigen_matrix $N $min_value $max_value >> $output_file_e) 2>> $output_file_e
-(sudo perf stat -r $num_repeticiones ./$FOLDER_EXE/matrix $N $min_value $max_value >> $output_file) 2>> $output_file
-(sudo perf stat -r $num_repeticiones ./$FOLDER_EXE/eigen_matrix $N $min_value $max_value >> $output_file_e) 2>> $output_file_e
+for (( i=1; i<=$num_repeticiones; i++ ))
+do
+    ./$FOLDER_EXE/matrix $N $min_value $max_value --perf >> $output_file 2>&1
+    ./$FOLDER_EXE/eigen_matrix $N $min_value $max_value --perf >> $output_file_e 2>&1
+done
 
 
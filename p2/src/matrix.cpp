@@ -1,36 +1,59 @@
 #include <iostream>
 #include <vector>
-#include <random>
 #include <cstdlib>
 #include <sys/time.h>  
+#include <string>
+#include "gemm_blocked.hpp"
+#include "perf_counters.hpp"
+#include "random_fill.hpp"
 using namespace std;
 
 /*
-    g++ src/matrix.cpp -o executable/matrix
-    time ./executable/matrix
+    g++ -I ../p1/include src/matrix.cpp -o executable/matrix
+    time ./executable/matrix <size> <min_value> <max_value> [naive|blocked] [--perf] [--seed=N]
+
+    --perf    imprime, tras los dos tiempos, los contadores hardware de las
+              regiones "init" y "multiply" (IPC, tasas de fallo, GFLOP/s)
+    --seed=N  semilla de las matrices aleatorias (A usa N y B N+1); sin ella
+              se toma una de random_device
 */
 
+// Algoritmo usado por Matrix<T>::operator* (mismo motor que p1)
+enum class mult_algorithm { naive, blocked };
+
+mult_algorithm parse_algorithm(const string& name) {
+    if (name == "naive") return mult_algorithm::naive;
+    if (name == "blocked") return mult_algorithm::blocked;
+    throw runtime_error("Unknown multiplication algorithm: " + name + ".");
+}
+
 template <typename T>
 class Matrix {
     unsigned int _n;
     T* m;
 
 public:
+    static mult_algorithm algorithm;
+
     Matrix(unsigned int n) : _n(n), m(new T[n*n]) {}
+    Matrix(Matrix&& other) : _n(other._n), m(other.m) { other.m = nullptr; }
+    Matrix(const Matrix&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
     ~Matrix() { delete[] m; }
 
-    void fill_random(T min_value = 1.0, T max_value = 100.0) {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_real_distribution<T> dis(min_value, max_value);
-        for (unsigned int i = 0; i < _n * _n; i++) {
-            m[i] = dis(gen);
-        }
+    // Philox en paralelo (reproducible con la misma semilla)
+    void fill_random(T min_value = 1.0, T max_value = 100.0, uint64_t seed = random_seed()) {
+        random_fill(m, size_t(_n) * _n, min_value, max_value, seed);
     }
 
-    friend Matrix operator*(const Matrix& a, const Matrix& b) {
-        if (a._n != b._n) throw runtime_error("Matrix size mismatch.");
-        Matrix<T> c(a._n);
+    // c = a * b sobre una matriz ya reservada: así la reserva y la liberación
+    // quedan fuera de la región medida
+    static void multiply(const Matrix& a, const Matrix& b, Matrix& c) {
+        if (a._n != b._n || a._n != c._n) throw runtime_error("Matrix size mismatch.");
+        if (algorithm == mult_algorithm::blocked) {
+            gemm_blocked<T>(a._n, a._n, a._n, T(1), a.m, a._n, 1, b.m, b._n, 1, T(0), c.m, c._n, 1);
+            return;
+        }
         for (unsigned int i = 0; i < a._n; i++) {
             for (unsigned int j = 0; j < a._n; j++) {
                 c.m[i*c._n+j] = 0;
@@ -39,10 +62,19 @@ public:
                 }
             }
         }
+    }
+
+    friend Matrix operator*(const Matrix& a, const Matrix& b) {
+        Matrix<T> c(a._n);
+        multiply(a, b, c);
         return c;
     }
 };
 
+// El naive sigue siendo el valor por defecto para que las series de results/ sean comparables
+template <typename T>
+mult_algorithm Matrix<T>::algorithm = mult_algorithm::naive;
+
 // Función para medir el tiempo usando gettimeofday()
 double get_time_in_seconds() {
     struct timeval tv;
@@ -51,33 +83,58 @@ double get_time_in_seconds() {
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value>" << endl;
+    if (argc < 4) {
+        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value> [naive|blocked] [--perf] [--seed=N]" << endl;
         return 1;
     }
 
     unsigned int size = atoi(argv[1]);
     double min_value = atof(argv[2]);
     double max_value = atof(argv[3]);
+    bool perf = false;
+    uint64_t seed = random_seed();
+    for (int i = 4; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--perf") {
+            perf = true;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = stoull(arg.substr(7));
+        } else {
+            Matrix<double>::algorithm = parse_algorithm(arg);
+        }
+    }
+
+    // Sin --perf no se abre ningún contador y measure() solo ejecuta la región
+    perf_counters counters(perf ? perf_default_events() : vector<perf_event_spec>());
+    if (perf && !counters.available()) {
+        cerr << "perf_event_open no disponible (revisa /proc/sys/kernel/perf_event_paranoid)" << endl;
+    }
 
     // Medir el tiempo de declaración, asignación y inicialización
     double start_init_time = get_time_in_seconds();
 
     Matrix<double> mat1(size);
     Matrix<double> mat2(size);
-    mat1.fill_random(min_value, max_value);
-    mat2.fill_random(min_value, max_value);
+    counters.measure("init", [&] {
+        mat1.fill_random(min_value, max_value, seed);
+        mat2.fill_random(min_value, max_value, seed + 1);
+    });
 
     double end_init_time = get_time_in_seconds();
     cout << (end_init_time - start_init_time) << "\n";
 
-    // Medir el tiempo de la multiplicación de matrices
+    // Medir el tiempo de la multiplicación de matrices (result se reserva antes)
+    Matrix<double> result(size);
     double start_mult_time = get_time_in_seconds();
 
-    Matrix<double> result = mat1 * mat2;
+    counters.measure("multiply", [&] { Matrix<double>::multiply(mat1, mat2, result); });
 
     double end_mult_time = get_time_in_seconds();
     cout << (end_mult_time - start_mult_time) << "\n";
 
+    if (perf) {
+        counters.report(cout);
+    }
+
     return 0;
 }
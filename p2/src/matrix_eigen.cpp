@@ -1,24 +1,19 @@
 #include <iostream>
 #include "../eigen-3.4.0/Eigen/Dense"  
-#include <random>
 #include <cstdlib>
 #include <sys/time.h> 
+#include <string>
+#include "perf_counters.hpp"
+#include "random_fill.hpp"
 
 using namespace std;
 using namespace Eigen;
 
-// Función para generar matrices aleatorias 
-MatrixXd generate_random_matrix(unsigned int size, double min_value, double max_value) {
+// Función para generar matrices aleatorias (Philox en paralelo, ver random_fill.hpp)
+MatrixXd generate_random_matrix(unsigned int size, double min_value, double max_value,
+                                uint64_t seed = random_seed()) {
     MatrixXd mat(size, size);
-    
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_real_distribution<> dis(min_value, max_value);  
-    
-    for (int i = 0; i < mat.size(); ++i) {
-        mat(i) = dis(gen);
-    }
-
+    random_fill(mat.data(), mat.size(), min_value, max_value, seed);
     return mat;
 }
 
@@ -30,12 +25,21 @@ double get_time_in_seconds() {
 }
 
 // Función para multiplicar matrices con medición de tiempos
-void multiplicar_matrix(unsigned int size, double min_value, double max_value, bool verbose=false) {
+// Con --perf se añaden los contadores hardware de las regiones "init" y "multiply"
+void multiplicar_matrix(unsigned int size, double min_value, double max_value, bool perf=false, bool verbose=false) {
+    perf_counters counters(perf ? perf_default_events() : vector<perf_event_spec>());
+    if (perf && !counters.available()) {
+        cerr << "perf_event_open no disponible (revisa /proc/sys/kernel/perf_event_paranoid)" << endl;
+    }
+
     // Medir el tiempo de declaración, asignación y generación de matrices aleatorias
     double start_init_time = get_time_in_seconds();
 
-    MatrixXd mat1 = generate_random_matrix(size, min_value, max_value);
-    MatrixXd mat2 = generate_random_matrix(size, min_value, max_value);
+    MatrixXd mat1, mat2;
+    counters.measure("init", [&] {
+        mat1 = generate_random_matrix(size, min_value, max_value);
+        mat2 = generate_random_matrix(size, min_value, max_value);
+    });
 
     double end_init_time = get_time_in_seconds();
     cout << (end_init_time - start_init_time) << "\n";
@@ -43,11 +47,16 @@ void multiplicar_matrix(unsigned int size, double min_value, double max_value, b
     // Medir el tiempo de la multiplicación de matrices
     double start_mult_time = get_time_in_seconds();
 
-    MatrixXd result = mat1 * mat2;
+    MatrixXd result;
+    counters.measure("multiply", [&] { result = mat1 * mat2; });
 
     double end_mult_time = get_time_in_seconds();
     cout << (end_mult_time - start_mult_time) << "\n";
 
+    if (perf) {
+        counters.report(cout);
+    }
+
     if (verbose) {
         cout << "Matrix 1:\n" << mat1 << endl;
         cout << "Matrix 2:\n" << mat2 << endl;
@@ -56,8 +65,8 @@ void multiplicar_matrix(unsigned int size, double min_value, double max_value, b
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 4) {
-        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value>" << endl;
+    if (argc != 4 && !(argc == 5 && string(argv[4]) == "--perf")) {
+        cerr << "Uso: " << argv[0] << " <size> <min_value> <max_value> [--perf]" << endl;
         return 1;
     }
 
@@ -65,7 +74,7 @@ int main(int argc, char* argv[]) {
     double min_value = atof(argv[2]);  
     double max_value = atof(argv[3]);  
 
-    multiplicar_matrix(size, min_value, max_value);
+    multiplicar_matrix(size, min_value, max_value, argc == 5);
 
     return 0;
 }
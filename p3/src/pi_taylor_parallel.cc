@@ -8,12 +8,20 @@
 #include <vector>
 #include <chrono>
 #include <fstream>
+#include <stdexcept>
+
+#include "pi_taylor_simd.h"
 
 using my_float = long double;
 
 void
 pi_taylor_chunk(std::vector<my_float> &output,
-        size_t thread_id, size_t start_step, size_t stop_step){
+        size_t thread_id, size_t start_step, size_t stop_step, pi_kernel kernel){
+
+    if (kernel != pi_kernel::long_double) {
+        output[thread_id] = pi_taylor_simd(kernel, start_step, stop_step);
+        return;
+    }
 
     my_float sum = 0.0;
 
@@ -29,7 +37,8 @@ std::pair<size_t, size_t>
 usage(int argc, const char *argv[]) {
     // read the number of steps from the command line
     if (argc < 3 || argc > 4) {
-        std::cerr << "Usage: pi_taylor_parallel <steps> <threads> [output_file]" << std::endl;
+        std::cerr << "Usage: pi_taylor_parallel <steps> <threads> [output_file] [--kernel=long_double|double|float]"
+            << std::endl;
         exit(1);
     }
 
@@ -59,6 +68,13 @@ void save_file(std::string output_file, int threads, std::chrono::duration<doubl
 int main(int argc, const char *argv[]) {
 
 
+    pi_kernel kernel = pi_kernel::long_double;
+    try {
+        kernel = take_kernel_option(argc, argv);
+    } catch (const std::invalid_argument &e) {
+        std::cerr << e.what() << std::endl;
+        argc = 0;
+    }
     auto ret_pair = usage(argc, argv);
     auto steps = ret_pair.first;
     auto threads = ret_pair.second;
@@ -74,7 +90,7 @@ int main(int argc, const char *argv[]) {
         size_t stop_step = steps * (i + 1) / threads;
     
         // Create a thread for each chunk
-        branch.emplace_back(pi_taylor_chunk, std::ref(pi_branch), i, start_step, stop_step);
+        branch.emplace_back(pi_taylor_chunk, std::ref(pi_branch), i, start_step, stop_step, kernel);
     }
     
     for (size_t i = 0; i < threads; i++) {
@@ -89,6 +105,7 @@ int main(int argc, const char *argv[]) {
     std::cout << "For " << steps << ", pi value: "
         << std::setprecision(std::numeric_limits<long double>::digits10 + 1)
         << pi << std::endl;
+    std::cout << "Kernel: " << pi_kernel_name(kernel) << ", " << steps / elapsed.count() << " terms/s" << std::endl;
 
     std::string output_file = (argc == 4) ? argv[3] : "results/4_execution_times.txt";
     save_file(output_file, threads, elapsed);
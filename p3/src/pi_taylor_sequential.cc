@@ -3,6 +3,9 @@
 #include <fstream>
 #include <limits>
 #include <chrono>
+#include <stdexcept>
+
+#include "pi_taylor_simd.h"
 
 // Allow to change the floating point type
 using my_float = long double;
@@ -20,16 +23,24 @@ my_float pi_taylor(size_t steps) {
 
 int main(int argc, const char *argv[]) {
 
+    pi_kernel kernel = pi_kernel::long_double;
+    try {
+        kernel = take_kernel_option(argc, argv);
+    } catch (const std::invalid_argument &e) {
+        std::cerr << e.what() << std::endl;
+        argc = 0;
+    }
+
     // read the number of steps from the command line
     if (argc < 2 || argc > 3) {
-        std::cerr << "Usage: pi_taylor <steps> [output_file]" << std::endl;
+        std::cerr << "Usage: pi_taylor <steps> [output_file] [--kernel=long_double|double|float]" << std::endl;
         exit(1);
 
     }
 
     size_t steps = std::stoll(argv[1]);
     auto start = std::chrono::high_resolution_clock::now();
-    auto pi = pi_taylor(steps);
+    my_float pi = kernel == pi_kernel::long_double ? pi_taylor(steps) : 4 * pi_taylor_simd(kernel, 0, steps);
     auto end = std::chrono::high_resolution_clock::now();
 
     std::chrono::duration<double> elapsed = end - start;
@@ -37,6 +48,7 @@ int main(int argc, const char *argv[]) {
     std::cout << "For " << steps << ", pi value: "
         << std::setprecision(std::numeric_limits<my_float>::digits10 + 1)
         << pi << std::endl;
+    std::cout << "Kernel: " << pi_kernel_name(kernel) << ", " << steps / elapsed.count() << " terms/s" << std::endl;
 
     std::string output_file = (argc == 3) ? argv[2] : "results/1_execution_times.txt";
 
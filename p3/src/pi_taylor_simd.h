@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// Kernel used to add the terms of the Taylor series:
+//   long_double  the reference loop, one term at a time on x87 long double
+//   double       paired terms on 4-wide double vectors
+//   float        paired terms on 8-wide float vectors
+//
+// Pairing an even term with the next odd one removes the sign:
+//   1/(4k+1) - 1/(4k+3) = 2 / ((4k+1)(4k+3))
+// so each pair costs one division and there is no i % 2 branch. The loop
+// keeps several independent vector accumulators so the divisions overlap,
+// and flushes them into a double at most every pi_simd_block iterations,
+// which keeps the float kernel within about 1e-8 of the double one even for
+// billions of terms.
+enum class pi_kernel { long_double, double_simd, float_simd };
+
+inline pi_kernel parse_pi_kernel(const std::string &name) {
+    if (name == "long_double") return pi_kernel::long_double;
+    if (name == "double") return pi_kernel::double_simd;
+    if (name == "float") return pi_kernel::float_simd;
+    throw std::invalid_argument("Unknown kernel: " + name);
+}
+
+inline const char *pi_kernel_name(pi_kernel kernel) {
+    switch (kernel) {
+    case pi_kernel::double_simd: return "double";
+    case pi_kernel::float_simd: return "float";
+    default: return "long_double";
+    }
+}
+
+// Removes a --kernel=<name> option from argv (so the positional arguments
+// keep their usual positions) and returns the chosen kernel
+inline pi_kernel take_kernel_option(int &argc, const char *argv[]) {
+    pi_kernel kernel = pi_kernel::long_double;
+    int out = 1;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--kernel=", 9) == 0) kernel = parse_pi_kernel(argv[i] + 9);
+        else argv[out++] = argv[i];
+    }
+    argc = out;
+    return kernel;
+}
+
+typedef double pi_v4d __attribute__((vector_size(32)));
+typedef float pi_v8f __attribute__((vector_size(32)));
+
+const size_t pi_simd_accumulators = 4;
+const size_t pi_simd_block = 256;
+
+// Sum of the pairs k = first .. first + pairs - 1 with vectors V of T.
+// The lane values are base + offset, with the offsets kept small (exact in
+// T) and the base recomputed from k every block, so float does not drift.
+template <typename V, typename T>
+static inline __attribute__((always_inline)) double
+pi_pairs(size_t first, size_t pairs) {
+    const size_t lanes = sizeof(V) / sizeof(T);
+    const size_t step = pi_simd_accumulators * lanes;   // pairs per iteration
+    const V two = V{} + T(2);
+    const V stride = V{} + T(4 * step);
+
+    double total = 0;
+    size_t k = first, end = first + pairs;
+    while (end - k >= step) {
+        // Blocks no longer than k pairs: within a block the terms shrink at
+        // most 4x, so a lane sum never gets far ahead of the terms it adds
+        size_t iters = std::min(std::min((end - k) / step, pi_simd_block), std::max<size_t>(1, k / step));
+        size_t block_end = k + iters * step;
+        const V base = V{} + T(4.0 * k + 1);
+        V offset[pi_simd_accumulators], acc[pi_simd_accumulators];
+        for (size_t u = 0; u < pi_simd_accumulators; u++) {
+            for (size_t l = 0; l < lanes; l++) offset[u][l] = T(4 * (u * lanes + l));
+            acc[u] = V{};
+        }
+        for (; k < block_end; k += step) {
+            for (size_t u = 0; u < pi_simd_accumulators; u++) {
+                V a = base + offset[u];
+                acc[u] += two / (a * (a + T(2)));
+                offset[u] += stride;
+            }
+        }
+        V sum = acc[0];
+        for (size_t u = 1; u < pi_simd_accumulators; u++) sum += acc[u];
+        for (size_t l = 0; l < lanes; l++) total += sum[l];
+    }
+    for (; k < end; k++) {
+        double a = 4.0 * k + 1;
+        total += 2.0 / (a * (a + 2));
+    }
+    return total;
+}
+
+// One clone per ISA, chosen at load time: AVX2 runs the 32-byte vectors in
+// one instruction, the default clone in two SSE2 halves
+__attribute__((target_clones("avx2", "default"))) static double
+pi_pairs_double(size_t first, size_t pairs) {
+    return pi_pairs<pi_v4d, double>(first, pairs);
+}
+
+__attribute__((target_clones("avx2", "default"))) static double
+pi_pairs_float(size_t first, size_t pairs) {
+    return pi_pairs<pi_v8f, float>(first, pairs);
+}
+
+// Sum of the terms start_step .. stop_step - 1 (without the factor 4) with a
+// SIMD kernel: a lone odd term at the start and a lone even one at the end,
+// pairs in between
+inline double pi_taylor_simd(pi_kernel kernel, size_t start_step, size_t stop_step) {
+    double sum = 0;
+    size_t i = start_step;
+    if (i < stop_step && i % 2 == 1) {
+        sum -= 1.0 / (2.0 * i + 1);
+        i++;
+    }
+    size_t pairs = (stop_step - i) / 2;
+    sum += kernel == pi_kernel::float_simd ? pi_pairs_float(i / 2, pairs) : pi_pairs_double(i / 2, pairs);
+    i += 2 * pairs;
+    if (i < stop_step) sum += 1.0 / (2.0 * i + 1);
+    return sum;
+}